@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+#include <ail/types.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+uword get_microseconds(boost::posix_time::ptime const & start);
+
+//a module with a while loop and a for loop which both sum the integers below the number of iterations
+std::string generate_loop_benchmark(uword iterations);
+//a module with the given number of functions which contain a bit of everything
+std::string generate_parser_benchmark(uword functions);
+
+bool perform_dispatch_benchmark(std::string const & input, std::string const & output);
+bool perform_copy_benchmark(std::string const & input, std::string const & output);
+
+bool perform_allocation_benchmark(std::string const & input, std::string const & output);
+bool perform_lexer_benchmark(std::string const & input, std::string const & output);
+bool perform_pipeline_benchmark(std::string const & input, std::string const & output);
+bool perform_cache_benchmark(std::string const & input, std::string const & directory);
+bool perform_incremental_benchmark(std::string const & input, std::string const & output);
@@ -0,0 +1,127 @@
+#include <iostream>
+
+#include <fridh/parser.hpp>
+#include <fridh/bytecode.hpp>
+
+#include <ail/file.hpp>
+#include <ail/string.hpp>
+
+#include <benchmark/benchmark.hpp>
+
+bool perform_dispatch_benchmark(std::string const & input, std::string const & output)
+{
+	uword const runs = 5;
+
+	std::string code = generate_loop_benchmark(ail::string_to_number<uword>(input));
+
+	fridh::module module;
+	fridh::parser parser;
+
+	std::string error;
+	if(!parser.process_data(code, "loop benchmark", module, error))
+	{
+		std::cout << "Error: " << error << std::endl;
+		return false;
+	}
+
+	fridh::bytecode_program program;
+	fridh::bytecode_compiler compiler;
+	if(!compiler.compile(module, program, error))
+	{
+		std::cout << "Error: " << error << std::endl;
+		return false;
+	}
+
+	fridh::dispatch_method::type const methods[] =
+	{
+		fridh::dispatch_method::switch_dispatch,
+		fridh::dispatch_method::direct_threading,
+	};
+
+	char const * const method_names[] =
+	{
+		"switch",
+		"direct threading",
+	};
+
+	std::string data;
+	uword best_times[2];
+	for(std::size_t i = 0; i < 2; i++)
+	{
+		fridh::virtual_machine machine(methods[i]);
+		for(uword run = 0; run < runs; run++)
+		{
+			fridh::variable result;
+			if(!machine.run(program, result, error))
+			{
+				std::cout << "Error: " << error << std::endl;
+				return false;
+			}
+
+			uword time = machine.get_statistics().microseconds;
+			if(run == 0 || time < best_times[i])
+				best_times[i] = time;
+		}
+
+		std::string line = std::string(method_names[i]) + ": " + machine.get_statistics().to_string() + ", best of " + ail::number_to_string(runs) + ": " + ail::number_to_string(best_times[i]) + " us";
+		std::cout << line << std::endl;
+		data += line + "\n";
+	}
+
+	if(best_times[1] > 0)
+	{
+		std::string line = "Speedup: " + ail::number_to_string(static_cast<double>(best_times[0]) / best_times[1]);
+		std::cout << line << std::endl;
+		data += line + "\n";
+	}
+
+	ail::write_file(output, data);
+	return true;
+}
+
+bool perform_copy_benchmark(std::string const & input, std::string const & output)
+{
+	uword const copies = 1000;
+
+	uword maximum_size = ail::string_to_number<uword>(input);
+
+	std::string data;
+	for(uword size = 1000; size <= maximum_size; size *= 10)
+	{
+		fridh::variable array;
+		array.new_array();
+		fridh::types::vector & elements = array.get_array();
+		elements.resize(size);
+		for(uword i = 0; i < size; i++)
+			elements[i].new_signed_integer(static_cast<fridh::types::signed_integer>(i));
+
+		//copies only share the payload of the array
+		boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+		uword checksum = 0;
+		for(uword i = 0; i < copies; i++)
+		{
+			fridh::variable const copy(array);
+			checksum += copy.get_array().size();
+		}
+		uword copy_time = get_microseconds(start);
+
+		//the first modification of a copy has to duplicate the elements
+		fridh::variable copy(array);
+		start = boost::posix_time::microsec_clock::universal_time();
+		copy.get_array()[0].new_signed_integer(-1);
+		uword write_time = get_microseconds(start);
+
+		if(checksum != copies * size)
+		{
+			std::cout << "Error: Invalid checksum" << std::endl;
+			return false;
+		}
+
+		std::string line = ail::number_to_string(size) + " element(s): " + ail::number_to_string(copies) + " copies in " + ail::number_to_string(copy_time) + " us, first write to a copy in " + ail::number_to_string(write_time) + " us";
+		std::cout << line << std::endl;
+		data += line + "\n";
+	}
+
+	ail::write_file(output, data);
+	return true;
+}
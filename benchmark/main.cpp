@@ -0,0 +1,100 @@
+#include <iostream>
+
+#include <ail/string.hpp>
+
+#include <benchmark/benchmark.hpp>
+
+uword get_microseconds(boost::posix_time::ptime const & start)
+{
+	return static_cast<uword>((boost::posix_time::microsec_clock::universal_time() - start).total_microseconds());
+}
+
+std::string generate_loop_benchmark(uword iterations)
+{
+	std::string limit = ail::number_to_string(iterations);
+	return
+		"@while_loop limit\n"
+		"\ti = 0\n"
+		"\ttotal = 0\n"
+		"\t\\\\ i < limit\n"
+		"\t\ttotal += i\n"
+		"\t\ti++\n"
+		"\t. total\n"
+		"\n"
+		"@for_loop limit\n"
+		"\ttotal = 0\n"
+		"\t\\\n"
+		"\ti = 0\n"
+		"\ti < limit\n"
+		"\ti++\n"
+		"\t\ttotal += i\n"
+		"\t. total\n"
+		"\n"
+		". while_loop[" + limit + "] + for_loop[" + limit + "]\n";
+}
+
+std::string generate_parser_benchmark(uword functions)
+{
+	std::string output;
+	for(uword i = 0; i < functions; i++)
+	{
+		std::string name = "function_" + ail::number_to_string(i);
+		output +=
+			"@" + name + " a b\n"
+			"\tx = a + b * 3 - -a / 2\n"
+			"\ty = {a b x \"text\" 1.5}\n"
+			"\t/ x > b && a != 0\n"
+			"\t\tx = 2 * f[a b + 1]\n"
+			"\t/\n"
+			"\t\tx++\n"
+			"\t\\ y\n"
+			"\t\tx += # << 1\n"
+			"\t. x\n"
+			"\n";
+	}
+	output += ". 0\n";
+	return output;
+}
+
+int main(int argc, char ** argv)
+{
+	if(argc != 4)
+	{
+		std::cout << argv[0] << " dispatch <iterations> <output>" << std::endl;
+		std::cout << argv[0] << " copy <maximum size> <output>" << std::endl;
+		std::cout << argv[0] << " allocation <functions> <output>" << std::endl;
+		std::cout << argv[0] << " lexer <functions> <output>" << std::endl;
+		std::cout << argv[0] << " pipeline <functions> <output>" << std::endl;
+		std::cout << argv[0] << " cache <input> <cache directory>" << std::endl;
+		std::cout << argv[0] << " incremental <functions> <output>" << std::endl;
+		return 1;
+	}
+
+	std::string
+		command = argv[1],
+		input = argv[2],
+		output = argv[3];
+
+	bool success;
+	if(command == "dispatch")
+		success = perform_dispatch_benchmark(input, output);
+	else if(command == "copy")
+		success = perform_copy_benchmark(input, output);
+	else if(command == "allocation")
+		success = perform_allocation_benchmark(input, output);
+	else if(command == "lexer")
+		success = perform_lexer_benchmark(input, output);
+	else if(command == "pipeline")
+		success = perform_pipeline_benchmark(input, output);
+	else if(command == "cache")
+		success = perform_cache_benchmark(input, output);
+	else if(command == "incremental")
+		success = perform_incremental_benchmark(input, output);
+	else
+	{
+		std::cout << "Unknown command" << std::endl;
+		return 1;
+	}
+
+	return success ? 0 : 1;
+}
@@ -0,0 +1,249 @@
+#include <iostream>
+
+#include <fridh/lexer.hpp>
+#include <fridh/source.hpp>
+#include <fridh/parser.hpp>
+#include <fridh/cache.hpp>
+#include <fridh/incremental.hpp>
+
+#include <ail/array.hpp>
+#include <ail/file.hpp>
+#include <ail/string.hpp>
+
+#include <benchmark/benchmark.hpp>
+
+bool perform_allocation_benchmark(std::string const & input, std::string const & output)
+{
+	std::string code = generate_parser_benchmark(ail::string_to_number<uword>(input));
+
+	fridh::module * module = new fridh::module;
+	fridh::parser parser;
+
+	boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+
+	std::string error;
+	if(!parser.process_data(code, "allocation benchmark", *module, error))
+	{
+		std::cout << "Error: " << error << std::endl;
+		delete module;
+		return false;
+	}
+
+	uword time = get_microseconds(start);
+	uword arena_allocations = module->arena.get_allocation_count();
+
+	//the blocks are taken out of the module first so the destruction of the trees and the release of the blocks are timed separately
+	fridh::memory_arena * blocks = new fridh::memory_arena;
+	blocks->swap(module->arena);
+
+	start = boost::posix_time::microsec_clock::universal_time();
+	delete module;
+	uword destruction_time = get_microseconds(start);
+
+	start = boost::posix_time::microsec_clock::universal_time();
+	delete blocks;
+	uword release_time = get_microseconds(start);
+
+	std::string data =
+		"Parsed " + ail::number_to_string(code.size()) + " byte(s) in " + ail::number_to_string(time) + " us\n"
+		"Arena allocations: " + ail::number_to_string(arena_allocations) + "\n"
+		"Destroyed the trees in " + ail::number_to_string(destruction_time) + " us\n"
+		"Released the arena blocks in " + ail::number_to_string(release_time) + " us\n";
+	std::cout << data;
+
+	ail::write_file(output, data);
+	return true;
+}
+
+bool perform_lexer_benchmark(std::string const & input, std::string const & output)
+{
+	uword const runs = 5;
+
+	fridh::scan_method::type const methods[] =
+	{
+		fridh::scan_method::scalar,
+		fridh::scan_method::sse2,
+		fridh::scan_method::avx2
+	};
+
+	std::string code = generate_parser_benchmark(ail::string_to_number<uword>(input));
+
+	fridh::scan_method::type default_method = fridh::get_scan_method();
+
+	std::string data;
+	for(std::size_t i = 0; i < ail::countof(methods); i++)
+	{
+		fridh::scan_method::type method = methods[i];
+		if(!fridh::scan_method_is_supported(method))
+			continue;
+
+		fridh::set_scan_method(method);
+
+		uword best_time = 0;
+		std::size_t line_count = 0;
+		for(uword run = 0; run < runs; run++)
+		{
+			fridh::lines_of_code lines;
+			fridh::lexer lexer(code, lines, true);
+
+			boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+			std::string error;
+			if(!lexer.parse(error))
+			{
+				std::cout << "Error: " << error << std::endl;
+				fridh::set_scan_method(default_method);
+				return false;
+			}
+			uword time = get_microseconds(start);
+			if(run == 0 || time < best_time)
+				best_time = time;
+			line_count = lines.size();
+		}
+
+		std::string line = fridh::get_scan_method_string(method) + ": Lexed " + ail::number_to_string(code.size()) + " byte(s) (" + ail::number_to_string(line_count) + " line(s)), best of " + ail::number_to_string(runs) + ": " + ail::number_to_string(best_time) + " us";
+		if(best_time > 0)
+			line += " (" + ail::number_to_string(static_cast<double>(code.size()) / best_time) + " MB/s)";
+		std::cout << line << std::endl;
+		data += line + "\n";
+	}
+
+	fridh::set_scan_method(default_method);
+
+	ail::write_file(output, data);
+	return true;
+}
+
+bool perform_pipeline_benchmark(std::string const & input, std::string const & output)
+{
+	uword const runs = 3;
+
+	std::string code = generate_parser_benchmark(ail::string_to_number<uword>(input));
+
+	std::string data;
+	for(int pipelined = 0; pipelined < 2; pipelined++)
+	{
+		uword best_time = 0;
+		for(uword run = 0; run < runs; run++)
+		{
+			fridh::module * module = new fridh::module;
+			fridh::parser parser(pipelined ? 0 : fridh::parser::no_pipeline);
+
+			boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+			std::string error;
+			if(!parser.process_data(code, "pipeline benchmark", *module, error))
+			{
+				std::cout << "Error: " << error << std::endl;
+				delete module;
+				return false;
+			}
+			uword time = get_microseconds(start);
+			if(run == 0 || time < best_time)
+				best_time = time;
+
+			delete module;
+		}
+
+		data += std::string(pipelined ? "Pipelined" : "Sequential") + ": Parsed " + ail::number_to_string(code.size()) + " byte(s), best of " + ail::number_to_string(runs) + ": " + ail::number_to_string(best_time) + " us\n";
+	}
+
+	std::cout << data;
+
+	ail::write_file(output, data);
+	return true;
+}
+
+bool perform_cache_benchmark(std::string const & input, std::string const & directory)
+{
+	fridh::source_buffer source;
+	if(!source.load(input))
+	{
+		std::cout << "Unable to read input" << std::endl;
+		return false;
+	}
+
+	fridh::module_cache cache(directory);
+	fridh::module parsed_module;
+	fridh::parser parser;
+
+	boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+	std::string error;
+	if(!parser.process_module(input, "cache benchmark", parsed_module, error))
+	{
+		std::cout << "Error: " << error << std::endl;
+		return false;
+	}
+	uword parse_time = get_microseconds(start);
+
+	start = boost::posix_time::microsec_clock::universal_time();
+	if(!cache.store(source.data(), source.size(), parsed_module))
+	{
+		std::cout << "Unable to write " << cache.get_path(source.data(), source.size()) << std::endl;
+		return false;
+	}
+	uword store_time = get_microseconds(start);
+
+	fridh::module cached_module;
+	start = boost::posix_time::microsec_clock::universal_time();
+	if(!cache.load(source.data(), source.size(), cached_module))
+	{
+		std::cout << "Unable to load " << cache.get_path(source.data(), source.size()) << std::endl;
+		return false;
+	}
+	uword load_time = get_microseconds(start);
+
+	std::cout << "Parsed " << source.size() << " byte(s) in " << parse_time << " us" << std::endl;
+	std::cout << "Stored " << cache.get_path(source.data(), source.size()) << " in " << store_time << " us" << std::endl;
+	std::cout << "Loaded it in " << load_time << " us" << std::endl;
+	return true;
+}
+
+bool perform_incremental_benchmark(std::string const & input, std::string const & output)
+{
+	uword functions = ail::string_to_number<uword>(input);
+	std::string code = generate_parser_benchmark(functions);
+
+	fridh::module parsed_module;
+	fridh::incremental_parser incremental_parser("incremental benchmark", parsed_module);
+	std::string error;
+	if(!incremental_parser.process_data(code.data(), code.size(), error))
+	{
+		std::cout << "Error: " << error << std::endl;
+		return false;
+	}
+
+	//edit the body of the function in the middle of the module
+	std::string target = "@function_" + ail::number_to_string(functions / 2) + " a b\n\tx = a + b * 3";
+	std::size_t offset = code.find(target);
+	if(offset == std::string::npos)
+	{
+		std::cout << "Unable to find the function to edit" << std::endl;
+		return false;
+	}
+	code[offset + target.size() - 1] = '4';
+
+	boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+	fridh::module full_module;
+	fridh::parser parser;
+	if(!parser.process_data(code, "incremental benchmark", full_module, error))
+	{
+		std::cout << "Error: " << error << std::endl;
+		return false;
+	}
+	uword full_time = get_microseconds(start);
+
+	start = boost::posix_time::microsec_clock::universal_time();
+	if(!incremental_parser.process_data(code.data(), code.size(), error))
+	{
+		std::cout << "Error: " << error << std::endl;
+		return false;
+	}
+	uword incremental_time = get_microseconds(start);
+
+	std::string data =
+		"Parsed " + ail::number_to_string(code.size()) + " byte(s) in " + ail::number_to_string(full_time) + " us\n"
+		"Updated " + ail::number_to_string(incremental_parser.get_parsed_block_count()) + " of " + ail::number_to_string(incremental_parser.get_block_count()) + " block(s) in " + ail::number_to_string(incremental_time) + " us\n";
+	std::cout << data;
+
+	ail::write_file(output, data);
+	return true;
+}
@@ -0,0 +1,571 @@
+#include <algorithm>
+#include <ail/string.hpp>
+#include <fridh/bytecode.hpp>
+#include <fridh/resolver.hpp>
+
+namespace fridh
+{
+	namespace
+	{
+		//target register used for expressions whose value is not used
+		uword const discard = ~static_cast<uword>(0);
+	}
+
+	bytecode_compiler::bytecode_compiler():
+		program(0)
+	{
+	}
+
+	bool bytecode_compiler::compile(module & target_module, bytecode_program & output, std::string & error_message)
+	{
+		output = bytecode_program();
+		program = &output;
+
+		try
+		{
+			resolve_module(target_module);
+
+			std::vector<symbol_tree_node *> nodes;
+
+			bytecode_function entry_function;
+			entry_function.name = target_module.path;
+			output.functions.push_back(entry_function);
+			output.function_indices[&target_module.entry_function] = 0;
+			output.entry_function = 0;
+			nodes.push_back(&target_module.symbols);
+
+			add_functions(target_module.symbols, "", nodes);
+
+			compile_function(target_module.entry_function, output.functions[0]);
+			for(std::size_t i = 1, end = nodes.size(); i < end; i++)
+				compile_function(*nodes[i]->function_pointer, output.functions[i]);
+
+			program = 0;
+			return true;
+		}
+		catch(ail::exception & exception)
+		{
+			error_message = target_module.path + ": " + exception.get_message();
+			program = 0;
+			return false;
+		}
+	}
+
+	void bytecode_compiler::add_functions(symbol_tree_node & node, std::string const & name, std::vector<symbol_tree_node *> & nodes)
+	{
+		for(node_children::iterator i = node.children.begin(), end = node.children.end(); i != end; i++)
+		{
+			symbol_tree_node & child = *i->second;
+			std::string child_name = get_atom_string(i->first);
+			if(!name.empty())
+				child_name = name + "." + child_name;
+			if(child.type == symbol::function)
+			{
+				program->function_indices[child.function_pointer] = program->functions.size();
+				bytecode_function new_function;
+				new_function.name = child_name;
+				program->functions.push_back(new_function);
+				nodes.push_back(&child);
+			}
+			add_functions(child, child_name, nodes);
+		}
+	}
+
+	void bytecode_compiler::compile_function(function & source, bytecode_function & output)
+	{
+		current_function = &output;
+		output.source = &source;
+		iterator_registers.clear();
+
+		for(atom_vector::iterator i = source.arguments.begin(), end = source.arguments.end(); i != end; i++)
+		{
+			if(std::find(source.arguments.begin(), i, *i) != i)
+				throw ail::exception("Duplicate argument name \"" + get_atom_string(*i) + "\" in function " + output.name);
+		}
+
+		//the local variables occupy the registers of their slots, the temporaries follow them
+		next_register = source.local_count;
+		maximum_register = next_register;
+
+		compile_units(source.body);
+		emit(opcode::return_nil);
+
+		output.argument_count = source.arguments.size();
+		output.register_count = maximum_register;
+	}
+
+	uword bytecode_compiler::allocate_register()
+	{
+		uword output = next_register;
+		next_register++;
+		if(next_register > maximum_register)
+			maximum_register = next_register;
+		return output;
+	}
+
+	uword bytecode_compiler::get_offset() const
+	{
+		return current_function->code.size();
+	}
+
+	uword bytecode_compiler::emit(opcode::type operation, uword a, uword b, uword c)
+	{
+		uword offset = get_offset();
+		current_function->code.push_back(instruction(operation, static_cast<boost::uint32_t>(a), static_cast<boost::uint32_t>(b), static_cast<boost::uint32_t>(c)));
+		return offset;
+	}
+
+	void bytecode_compiler::patch(uword offset, uword target)
+	{
+		instruction & current_instruction = current_function->code[offset];
+		boost::uint32_t target_operand = static_cast<boost::uint32_t>(target);
+		switch(current_instruction.operation)
+		{
+			case opcode::jump:
+				current_instruction.a = target_operand;
+				break;
+
+			case opcode::jump_if_true:
+			case opcode::jump_if_false:
+				current_instruction.b = target_operand;
+				break;
+
+			case opcode::for_each_next:
+				current_instruction.c = target_operand;
+				break;
+
+			default:
+				throw ail::exception("Internal error: Tried to patch a non-jump instruction");
+		}
+	}
+
+	uword bytecode_compiler::add_constant(variable const & constant)
+	{
+		uword index = program->constants.size();
+		program->constants.push_back(constant);
+		return index;
+	}
+
+	void bytecode_compiler::compile_units(executable_units const & units)
+	{
+		for(executable_units::const_iterator i = units.begin(), end = units.end(); i != end; i++)
+			compile_unit(*i);
+	}
+
+	void bytecode_compiler::compile_loop(parse_tree_node const & conditional, executable_units const & body, parse_tree_node const * iteration)
+	{
+		//the condition is placed at the end of the loop so every iteration only performs a single jump
+		uword entry_jump = emit(opcode::jump);
+		uword body_offset = get_offset();
+		compile_units(body);
+		if(iteration)
+		{
+			uword mark = next_register;
+			compile_expression(*iteration, discard);
+			next_register = mark;
+		}
+		patch(entry_jump, get_offset());
+		uword mark = next_register;
+		uword condition = compile_operand(conditional);
+		emit(opcode::jump_if_true, condition, body_offset);
+		next_register = mark;
+	}
+
+	void bytecode_compiler::compile_for_each(for_each_statement const & statement)
+	{
+		uword mark = next_register;
+
+		uword container = allocate_register();
+		compile_expression(statement.container, container);
+
+		variable zero;
+		zero.new_unsigned_integer(0);
+		uword index = allocate_register();
+		emit(opcode::load_constant, index, add_constant(zero));
+
+		uword iterator = allocate_register();
+		iterator_registers.push_back(iterator);
+
+		uword next_offset = emit(opcode::for_each_next, container, index);
+		compile_units(statement.body);
+		emit(opcode::jump, next_offset);
+		patch(next_offset, get_offset());
+
+		iterator_registers.pop_back();
+		next_register = mark;
+	}
+
+	void bytecode_compiler::compile_unit(executable_unit const & unit)
+	{
+		uword mark = next_register;
+
+		switch(unit.type)
+		{
+			case executable_unit_type::statement:
+				compile_expression(*unit.statement_pointer, discard);
+				break;
+
+			case executable_unit_type::return_statement:
+				emit(opcode::return_value, compile_operand(*unit.statement_pointer));
+				break;
+
+			case executable_unit_type::if_statement:
+			{
+				if_statement const & statement = *unit.if_pointer;
+				uword end_jump = emit(opcode::jump_if_false, compile_operand(statement.conditional_term));
+				next_register = mark;
+				compile_units(statement.body);
+				patch(end_jump, get_offset());
+				break;
+			}
+
+			case executable_unit_type::if_else_statement:
+			{
+				if_else_statement const & statement = *unit.if_else_pointer;
+				uword else_jump = emit(opcode::jump_if_false, compile_operand(statement.conditional_term));
+				next_register = mark;
+				compile_units(statement.if_body);
+				uword end_jump = emit(opcode::jump);
+				patch(else_jump, get_offset());
+				compile_units(statement.else_body);
+				patch(end_jump, get_offset());
+				break;
+			}
+
+			case executable_unit_type::for_each_statement:
+				compile_for_each(*unit.for_each_pointer);
+				break;
+
+			case executable_unit_type::for_statement:
+			{
+				for_statement const & statement = *unit.for_pointer;
+				compile_expression(statement.initialisation, discard);
+				next_register = mark;
+				compile_loop(statement.conditional, statement.body, &statement.iteration);
+				break;
+			}
+
+			case executable_unit_type::while_statement:
+			{
+				while_statement const & statement = *unit.while_pointer;
+				compile_loop(statement.conditional_term, statement.body, 0);
+				break;
+			}
+
+			default:
+				throw ail::exception("Encountered an uninitialised executable unit");
+		}
+
+		next_register = mark;
+	}
+
+	uword bytecode_compiler::get_local(parse_tree_node const & node)
+	{
+		if(node.type != parse_tree_node_type::symbol)
+			throw ail::exception("Assignments are only supported for symbols at this point");
+		return node.symbol_pointer->slot;
+	}
+
+	uword bytecode_compiler::compile_operand(parse_tree_node const & node)
+	{
+		switch(node.type)
+		{
+			case parse_tree_node_type::symbol:
+				if(node.symbol_pointer->slot != parse_tree_symbol::no_slot)
+					return node.symbol_pointer->slot;
+				break;
+
+			case parse_tree_node_type::iterator:
+				if(iterator_registers.empty())
+					throw ail::exception("Encountered an iterator outside of a for each statement");
+				return iterator_registers.back();
+
+			default:
+				break;
+		}
+
+		uword output = allocate_register();
+		compile_expression(node, output);
+		return output;
+	}
+
+	void bytecode_compiler::compile_expression(parse_tree_node const & node, uword target)
+	{
+		switch(node.type)
+		{
+			case parse_tree_node_type::variable:
+				if(target != discard)
+					emit(opcode::load_constant, target, add_constant(*node.variable_pointer));
+				return;
+
+			case parse_tree_node_type::symbol:
+				compile_symbol(*node.symbol_pointer, target);
+				return;
+
+			case parse_tree_node_type::unary_operator_node:
+				compile_unary_operator(*node.unary_operator_pointer, target);
+				return;
+
+			case parse_tree_node_type::binary_operator_node:
+				compile_binary_operator(*node.binary_operator_pointer, target);
+				return;
+
+			case parse_tree_node_type::call:
+				compile_call(*node.call_pointer, target);
+				return;
+
+			case parse_tree_node_type::array:
+				compile_array(*node.array_pointer, target);
+				return;
+
+			case parse_tree_node_type::iterator:
+			{
+				uword iterator = compile_operand(node);
+				if(target != discard)
+					emit(opcode::move, target, iterator);
+				return;
+			}
+
+			default:
+				throw ail::exception("Unable to compile parse tree node of type " + node.to_string());
+		}
+	}
+
+	void bytecode_compiler::compile_symbol(parse_tree_symbol const & symbol, uword target)
+	{
+		if(symbol.slot != parse_tree_symbol::no_slot)
+		{
+			if(target != discard)
+				emit(opcode::move, target, symbol.slot);
+			return;
+		}
+
+		if(symbol.function_node != 0)
+		{
+			if(target != discard)
+				emit(opcode::load_function, target, program->function_indices[symbol.function_node->function_pointer]);
+			return;
+		}
+
+		throw ail::exception("Unknown symbol \"" + get_atom_string(symbol.name) + "\"");
+	}
+
+	void bytecode_compiler::compile_unary_operator(parse_tree_unary_operator_node const & node, uword target)
+	{
+		switch(node.type)
+		{
+			case unary_operator_type::increment:
+			case unary_operator_type::decrement:
+			{
+				uword local = get_local(node.argument);
+				if(target != discard)
+					emit(opcode::move, target, local);
+				emit(node.type == unary_operator_type::increment ? opcode::increment : opcode::decrement, local);
+				return;
+			}
+
+			default:
+				break;
+		}
+
+		uword mark = next_register;
+		if(target == discard)
+			target = allocate_register();
+		uword argument = compile_operand(node.argument);
+
+		switch(node.type)
+		{
+			case unary_operator_type::negation:
+				emit(opcode::negation, target, argument);
+				break;
+
+			case unary_operator_type::logical_not:
+				emit(opcode::logical_not, target, argument);
+				break;
+
+			case unary_operator_type::binary_not:
+				emit(opcode::binary_not, target, argument);
+				break;
+
+			default:
+				throw ail::exception("Internal error: Invalid unary operator type encountered");
+		}
+
+		next_register = mark;
+	}
+
+	void bytecode_compiler::compile_assignment(parse_tree_binary_operator_node const & node, uword target)
+	{
+		uword local = get_local(node.left_argument);
+		uword mark = next_register;
+
+#define COMPOUND_ASSIGNMENT(type, operation) \
+			case binary_operator_type::type: \
+				emit(opcode::operation, local, local, compile_operand(node.right_argument)); \
+				break;
+
+		switch(node.type)
+		{
+			case binary_operator_type::assignment:
+				compile_expression(node.right_argument, local);
+				break;
+
+			COMPOUND_ASSIGNMENT(addition_assignment, addition)
+			COMPOUND_ASSIGNMENT(subtraction_assignment, subtraction)
+			COMPOUND_ASSIGNMENT(multiplication_assignment, multiplication)
+			COMPOUND_ASSIGNMENT(division_assignment, division)
+			COMPOUND_ASSIGNMENT(modulo_assignment, modulo)
+
+			case binary_operator_type::exponentiation_assignment:
+				throw ail::exception("Exponentiation has not been implemented yet");
+
+			default:
+				throw ail::exception("Internal error: Invalid assignment operator type encountered");
+		}
+
+#undef COMPOUND_ASSIGNMENT
+
+		next_register = mark;
+
+		if(target != discard)
+			emit(opcode::move, target, local);
+	}
+
+	void bytecode_compiler::compile_binary_operator(parse_tree_binary_operator_node const & node, uword target)
+	{
+		switch(node.type)
+		{
+			case binary_operator_type::assignment:
+			case binary_operator_type::addition_assignment:
+			case binary_operator_type::subtraction_assignment:
+			case binary_operator_type::multiplication_assignment:
+			case binary_operator_type::division_assignment:
+			case binary_operator_type::modulo_assignment:
+			case binary_operator_type::exponentiation_assignment:
+				compile_assignment(node, target);
+				return;
+
+			case binary_operator_type::exponentiation:
+				throw ail::exception("Exponentiation has not been implemented yet");
+
+			case binary_operator_type::selection:
+				throw ail::exception("Selection has not been implemented yet");
+
+			default:
+				break;
+		}
+
+		uword mark = next_register;
+		if(target == discard)
+			target = allocate_register();
+		uword left = compile_operand(node.left_argument);
+		uword right = compile_operand(node.right_argument);
+
+#define BINARY_OPERATION(type) \
+			case binary_operator_type::type: \
+				emit(opcode::type, target, left, right); \
+				break;
+
+		switch(node.type)
+		{
+			BINARY_OPERATION(addition)
+			BINARY_OPERATION(subtraction)
+			BINARY_OPERATION(multiplication)
+			BINARY_OPERATION(division)
+			BINARY_OPERATION(modulo)
+
+			BINARY_OPERATION(less_than)
+			BINARY_OPERATION(less_than_or_equal)
+			BINARY_OPERATION(greater_than)
+			BINARY_OPERATION(greater_than_or_equal)
+			BINARY_OPERATION(not_equal)
+			BINARY_OPERATION(equal)
+
+			BINARY_OPERATION(logical_and)
+			BINARY_OPERATION(logical_or)
+
+			BINARY_OPERATION(shift_left)
+			BINARY_OPERATION(shift_right)
+
+			BINARY_OPERATION(binary_and)
+			BINARY_OPERATION(binary_or)
+			BINARY_OPERATION(binary_xor)
+
+			default:
+				throw ail::exception("Internal error: Invalid binary operator type encountered");
+		}
+
+#undef BINARY_OPERATION
+
+		next_register = mark;
+	}
+
+	void bytecode_compiler::compile_call(parse_tree_call const & call, uword target)
+	{
+		uword mark = next_register;
+		uword argument_count = call.arguments.size();
+
+		//calls to functions known at compile time skip the function register
+		bool is_direct_call = false;
+		uword function_index;
+		if(call.function.type == parse_tree_node_type::symbol)
+		{
+			parse_tree_symbol const & symbol = *call.function.symbol_pointer;
+			symbol_tree_node * node = symbol.function_node;
+			if(symbol.slot == parse_tree_symbol::no_slot && node != 0)
+			{
+				is_direct_call = true;
+				function_index = program->function_indices[node->function_pointer];
+				uword expected_argument_count = node->function_pointer->arguments.size();
+				if(argument_count != expected_argument_count)
+					throw ail::exception("Invalid argument count in call to \"" + get_atom_string(symbol.name) + "\": expected " + ail::number_to_string(expected_argument_count) + ", got " + ail::number_to_string(argument_count));
+			}
+		}
+
+		//the arguments are placed in consecutive registers which become the first registers of the frame of the callee
+		uword base = allocate_register();
+		uword argument_base = base;
+		if(!is_direct_call)
+		{
+			compile_expression(call.function, base);
+			argument_base = allocate_register();
+		}
+
+		for(uword i = 0; i < argument_count; i++)
+		{
+			uword argument = argument_base + i;
+			next_register = argument;
+			allocate_register();
+			compile_expression(call.arguments[i], argument);
+		}
+
+		if(target == discard)
+			target = base;
+
+		if(is_direct_call)
+			emit(opcode::call_direct, target, base, function_index);
+		else
+			emit(opcode::call, target, base, argument_count);
+
+		next_register = mark;
+	}
+
+	void bytecode_compiler::compile_array(parse_tree_array const & array, uword target)
+	{
+		uword mark = next_register;
+		uword element_count = array.elements.size();
+		uword base = next_register;
+		for(uword i = 0; i < element_count; i++)
+		{
+			uword element = base + i;
+			next_register = element;
+			allocate_register();
+			compile_expression(array.elements[i], element);
+		}
+
+		if(target != discard)
+			emit(opcode::new_array, target, base, element_count);
+
+		next_register = mark;
+	}
+}
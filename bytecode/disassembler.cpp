@@ -0,0 +1,230 @@
+#include <ail/string.hpp>
+#include <fridh/bytecode.hpp>
+
+namespace fridh
+{
+	namespace
+	{
+		std::string register_string(boost::uint32_t index)
+		{
+			return "r" + ail::number_to_string(index);
+		}
+
+		std::string offset_string(boost::uint32_t offset)
+		{
+			std::string output = ail::number_to_string(offset);
+			while(output.size() < 4)
+				output = "0" + output;
+			return output;
+		}
+
+		std::string constant_string(variable const & constant)
+		{
+			switch(constant.get_type())
+			{
+				case variable_type_identifier::nil:
+					return "nil";
+
+				case variable_type_identifier::string:
+					return "\"" + ail::replace_string(constant.get_string_representation(), "\n", "\\n") + "\"";
+
+				case variable_type_identifier::boolean:
+				case variable_type_identifier::signed_integer:
+				case variable_type_identifier::unsigned_integer:
+				case variable_type_identifier::floating_point_value:
+					return constant.get_string_representation();
+
+				default:
+					return get_type_string(constant.get_type());
+			}
+		}
+
+		std::string disassemble_instruction(bytecode_program const & program, instruction const & current_instruction)
+		{
+			std::string output = get_opcode_string(current_instruction.operation);
+			while(output.size() < 16)
+				output += " ";
+
+			std::string
+				a = register_string(current_instruction.a),
+				b = register_string(current_instruction.b),
+				c = register_string(current_instruction.c);
+
+			switch(current_instruction.operation)
+			{
+				case opcode::move:
+				case opcode::negation:
+				case opcode::logical_not:
+				case opcode::binary_not:
+					return output + a + ", " + b;
+
+				case opcode::load_constant:
+					return output + a + ", k" + ail::number_to_string(current_instruction.b) + " (" + constant_string(program.constants[current_instruction.b]) + ")";
+
+				case opcode::load_function:
+					return output + a + ", " + program.functions[current_instruction.b].name;
+
+				case opcode::increment:
+				case opcode::decrement:
+				case opcode::return_value:
+					return output + a;
+
+				case opcode::new_array:
+					return output + a + ", " + b + ", " + ail::number_to_string(current_instruction.c);
+
+				case opcode::jump:
+					return output + offset_string(current_instruction.a);
+
+				case opcode::jump_if_true:
+				case opcode::jump_if_false:
+					return output + a + ", " + offset_string(current_instruction.b);
+
+				case opcode::call_direct:
+					return output + a + ", " + b + ", " + program.functions[current_instruction.c].name;
+
+				case opcode::call:
+					return output + a + ", " + b + ", " + ail::number_to_string(current_instruction.c);
+
+				case opcode::for_each_next:
+					return output + a + ", " + b + ", " + offset_string(current_instruction.c);
+
+				case opcode::return_nil:
+					return output;
+
+				default:
+					return output + a + ", " + b + ", " + c;
+			}
+		}
+	}
+
+	std::string get_opcode_string(opcode::type operation)
+	{
+		switch(operation)
+		{
+			case opcode::move:
+				return "move";
+
+			case opcode::load_constant:
+				return "load_constant";
+
+			case opcode::load_function:
+				return "load_function";
+
+			case opcode::negation:
+				return "negation";
+
+			case opcode::logical_not:
+				return "logical_not";
+
+			case opcode::binary_not:
+				return "binary_not";
+
+			case opcode::increment:
+				return "increment";
+
+			case opcode::decrement:
+				return "decrement";
+
+			case opcode::addition:
+				return "addition";
+
+			case opcode::subtraction:
+				return "subtraction";
+
+			case opcode::multiplication:
+				return "multiplication";
+
+			case opcode::division:
+				return "division";
+
+			case opcode::modulo:
+				return "modulo";
+
+			case opcode::less_than:
+				return "less_than";
+
+			case opcode::less_than_or_equal:
+				return "less_than_or_equal";
+
+			case opcode::greater_than:
+				return "greater_than";
+
+			case opcode::greater_than_or_equal:
+				return "greater_than_or_equal";
+
+			case opcode::not_equal:
+				return "not_equal";
+
+			case opcode::equal:
+				return "equal";
+
+			case opcode::logical_and:
+				return "logical_and";
+
+			case opcode::logical_or:
+				return "logical_or";
+
+			case opcode::shift_left:
+				return "shift_left";
+
+			case opcode::shift_right:
+				return "shift_right";
+
+			case opcode::binary_and:
+				return "binary_and";
+
+			case opcode::binary_or:
+				return "binary_or";
+
+			case opcode::binary_xor:
+				return "binary_xor";
+
+			case opcode::new_array:
+				return "new_array";
+
+			case opcode::jump:
+				return "jump";
+
+			case opcode::jump_if_true:
+				return "jump_if_true";
+
+			case opcode::jump_if_false:
+				return "jump_if_false";
+
+			case opcode::call_direct:
+				return "call_direct";
+
+			case opcode::call:
+				return "call";
+
+			case opcode::for_each_next:
+				return "for_each_next";
+
+			case opcode::return_value:
+				return "return_value";
+
+			case opcode::return_nil:
+				return "return_nil";
+		}
+
+		return "unknown (" + ail::number_to_string(static_cast<int>(operation)) + ")";
+	}
+
+	std::string disassemble(bytecode_program const & program)
+	{
+		std::string output;
+
+		for(std::size_t i = 0, end = program.functions.size(); i < end; i++)
+		{
+			bytecode_function const & function = program.functions[i];
+			if(i > 0)
+				output += "\n";
+			output += "function " + function.name + " (" + ail::number_to_string(function.argument_count) + " argument(s), " + ail::number_to_string(function.register_count) + " register(s))\n";
+
+			for(std::size_t offset = 0, code_end = function.code.size(); offset < code_end; offset++)
+				output += "    " + offset_string(offset) + ": " + disassemble_instruction(program, function.code[offset]) + "\n";
+		}
+
+		return output;
+	}
+}
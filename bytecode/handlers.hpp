@@ -0,0 +1,139 @@
+//instruction handlers of the virtual machine, included by both dispatch loops in machine.cpp
+//FRIDH_OPCODE(name) starts the handler of an opcode and FRIDH_NEXT dispatches the next instruction
+
+FRIDH_OPCODE(move)
+	frame[current_instruction->a] = frame[current_instruction->b];
+	FRIDH_NEXT
+
+FRIDH_OPCODE(load_constant)
+	frame[current_instruction->a] = constants[current_instruction->b];
+	FRIDH_NEXT
+
+FRIDH_OPCODE(load_function)
+	frame[current_instruction->a].new_function(program->functions[current_instruction->b].source);
+	FRIDH_NEXT
+
+#define FRIDH_UNARY_OPERATION(type) \
+FRIDH_OPCODE(type) \
+	frame[current_instruction->b].type(frame[current_instruction->a]); \
+	FRIDH_NEXT
+
+FRIDH_UNARY_OPERATION(negation)
+FRIDH_UNARY_OPERATION(logical_not)
+FRIDH_UNARY_OPERATION(binary_not)
+
+#undef FRIDH_UNARY_OPERATION
+
+FRIDH_OPCODE(increment)
+	frame[current_instruction->a].addition(one, frame[current_instruction->a]);
+	FRIDH_NEXT
+
+FRIDH_OPCODE(decrement)
+	frame[current_instruction->a].subtraction(one, frame[current_instruction->a]);
+	FRIDH_NEXT
+
+#define FRIDH_BINARY_OPERATION(type) \
+FRIDH_OPCODE(type) \
+	frame[current_instruction->b].type(frame[current_instruction->c], frame[current_instruction->a]); \
+	FRIDH_NEXT
+
+FRIDH_BINARY_OPERATION(addition)
+FRIDH_BINARY_OPERATION(subtraction)
+FRIDH_BINARY_OPERATION(multiplication)
+FRIDH_BINARY_OPERATION(division)
+FRIDH_BINARY_OPERATION(modulo)
+
+FRIDH_BINARY_OPERATION(less_than)
+FRIDH_BINARY_OPERATION(less_than_or_equal)
+FRIDH_BINARY_OPERATION(greater_than)
+FRIDH_BINARY_OPERATION(greater_than_or_equal)
+FRIDH_BINARY_OPERATION(not_equal)
+FRIDH_BINARY_OPERATION(equal)
+
+FRIDH_BINARY_OPERATION(logical_and)
+FRIDH_BINARY_OPERATION(logical_or)
+
+FRIDH_BINARY_OPERATION(shift_left)
+FRIDH_BINARY_OPERATION(shift_right)
+
+FRIDH_BINARY_OPERATION(binary_and)
+FRIDH_BINARY_OPERATION(binary_or)
+FRIDH_BINARY_OPERATION(binary_xor)
+
+#undef FRIDH_BINARY_OPERATION
+
+FRIDH_OPCODE(new_array)
+	{
+		variable array;
+		array.new_array();
+		variable * elements = frame + current_instruction->b;
+		array.get_array().assign(elements, elements + current_instruction->c);
+		frame[current_instruction->a] = array;
+	}
+	FRIDH_NEXT
+
+FRIDH_OPCODE(jump)
+	current = code + current_instruction->a;
+	FRIDH_NEXT
+
+FRIDH_OPCODE(jump_if_true)
+	if(frame[current_instruction->a].get_boolean_value())
+		current = code + current_instruction->b;
+	FRIDH_NEXT
+
+FRIDH_OPCODE(jump_if_false)
+	if(!frame[current_instruction->a].get_boolean_value())
+		current = code + current_instruction->b;
+	FRIDH_NEXT
+
+FRIDH_OPCODE(call_direct)
+	{
+		variable result;
+		call_function(current_instruction->c, base + current_instruction->b, result);
+		//the register stack may have been reallocated by the callee
+		frame = &registers[base];
+		frame[current_instruction->a] = result;
+	}
+	FRIDH_NEXT
+
+FRIDH_OPCODE(call)
+	{
+		function * target = frame[current_instruction->b].get_function();
+		std::map<function *, uword>::const_iterator iterator = program->function_indices.find(target);
+		if(iterator == program->function_indices.end())
+			throw ail::exception("Unable to find the bytecode of a function");
+		uword function_index = iterator->second;
+		if(current_instruction->c != program->functions[function_index].argument_count)
+			throw ail::exception("Invalid argument count in function call");
+
+		variable result;
+		call_function(function_index, base + current_instruction->b + 1, result);
+		frame = &registers[base];
+		frame[current_instruction->a] = result;
+	}
+	FRIDH_NEXT
+
+FRIDH_OPCODE(for_each_next)
+	{
+		//read only access so the array stays shared with the variable it was loaded from
+		variable const & container = frame[current_instruction->a];
+		types::vector const & elements = container.get_array();
+		variable & index = frame[current_instruction->b];
+		types::unsigned_integer position = index.get_unsigned_integer();
+		if(position < elements.size())
+		{
+			frame[current_instruction->b + 1] = elements[position];
+			index.new_unsigned_integer(position + 1);
+		}
+		else
+			current = code + current_instruction->c;
+	}
+	FRIDH_NEXT
+
+FRIDH_OPCODE(return_value)
+	output = frame[current_instruction->a];
+	return;
+
+FRIDH_OPCODE(return_nil)
+	output.nil();
+	return;
@@ -0,0 +1,194 @@
+#include <boost/static_assert.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <fridh/bytecode.hpp>
+
+namespace fridh
+{
+	virtual_machine::virtual_machine(dispatch_method::type method):
+		method(method),
+		program(0)
+	{
+	}
+
+	bool virtual_machine::run(bytecode_program const & target_program, variable & output, std::string & error_message)
+	{
+		program = &target_program;
+		statistics = execution_statistics();
+		registers.clear();
+		registers.reserve(1024);
+
+		boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+
+		bool success = true;
+		try
+		{
+			call_function(program->entry_function, 0, output);
+		}
+		catch(ail::exception & exception)
+		{
+			error_message = program->functions[program->entry_function].name + ": " + exception.get_message();
+			success = false;
+		}
+
+		boost::posix_time::ptime end = boost::posix_time::microsec_clock::universal_time();
+		statistics.microseconds = static_cast<uword>((end - start).total_microseconds());
+
+		registers.clear();
+		program = 0;
+
+		return success;
+	}
+
+	execution_statistics const & virtual_machine::get_statistics() const
+	{
+		return statistics;
+	}
+
+	void virtual_machine::call_function(uword function_index, std::size_t base, variable & output)
+	{
+		bytecode_function const & target_function = program->functions[function_index];
+
+		std::size_t frame_end = base + target_function.register_count;
+		if(registers.size() < frame_end)
+			registers.resize(frame_end);
+
+		//the arguments have already been placed in the first registers of the frame by the caller
+		for(std::size_t i = base + target_function.argument_count; i < frame_end; i++)
+			registers[i].destroy();
+
+		execute(target_function, base, output);
+	}
+
+	void virtual_machine::execute(bytecode_function const & target_function, std::size_t base, variable & output)
+	{
+		if(method == dispatch_method::direct_threading)
+			execute_threaded(target_function, base, output);
+		else
+			execute_switch(target_function, base, output);
+	}
+
+#define FRIDH_DISPATCH_STATE \
+		instruction const * code = &target_function.code[0]; \
+		instruction const * current = code; \
+		instruction const * current_instruction; \
+		variable const * constants = program->constants.empty() ? 0 : &program->constants[0]; \
+		variable * frame = &registers[base]; \
+		variable one; \
+		one.new_signed_integer(1);
+
+	void virtual_machine::execute_switch(bytecode_function const & target_function, std::size_t base, variable & output)
+	{
+		FRIDH_DISPATCH_STATE
+
+#define FRIDH_OPCODE(name) case opcode::name:
+#define FRIDH_NEXT break;
+
+		while(true)
+		{
+			current_instruction = current;
+			current++;
+			statistics.instructions++;
+
+			switch(current_instruction->operation)
+			{
+
+#include "handlers.hpp"
+
+				default:
+					throw ail::exception("Encountered an invalid opcode");
+			}
+		}
+
+#undef FRIDH_NEXT
+#undef FRIDH_OPCODE
+
+	}
+
+#ifdef FRIDH_HAS_COMPUTED_GOTO
+
+	void virtual_machine::execute_threaded(bytecode_function const & target_function, std::size_t base, variable & output)
+	{
+		FRIDH_DISPATCH_STATE
+
+		//must match the order of opcode::type
+		static void * const labels[] =
+		{
+			&&move_label,
+			&&load_constant_label,
+			&&load_function_label,
+
+			&&negation_label,
+			&&logical_not_label,
+			&&binary_not_label,
+
+			&&increment_label,
+			&&decrement_label,
+
+			&&addition_label,
+			&&subtraction_label,
+			&&multiplication_label,
+			&&division_label,
+			&&modulo_label,
+
+			&&less_than_label,
+			&&less_than_or_equal_label,
+			&&greater_than_label,
+			&&greater_than_or_equal_label,
+			&&not_equal_label,
+			&&equal_label,
+
+			&&logical_and_label,
+			&&logical_or_label,
+
+			&&shift_left_label,
+			&&shift_right_label,
+
+			&&binary_and_label,
+			&&binary_or_label,
+			&&binary_xor_label,
+
+			&&new_array_label,
+
+			&&jump_label,
+			&&jump_if_true_label,
+			&&jump_if_false_label,
+
+			&&call_direct_label,
+			&&call_label,
+
+			&&for_each_next_label,
+
+			&&return_value_label,
+			&&return_nil_label,
+		};
+
+		BOOST_STATIC_ASSERT(sizeof(labels) / sizeof(labels[0]) == opcode::return_nil + 1);
+
+		//every handler ends in its own indirect jump so the branch predictor can learn the successors of each opcode separately
+#define FRIDH_OPCODE(name) name##_label:
+#define FRIDH_NEXT \
+		current_instruction = current; \
+		current++; \
+		statistics.instructions++; \
+		goto *labels[current_instruction->operation];
+
+		FRIDH_NEXT
+
+#include "handlers.hpp"
+
+#undef FRIDH_NEXT
+#undef FRIDH_OPCODE
+
+	}
+
+#else
+
+	void virtual_machine::execute_threaded(bytecode_function const & target_function, std::size_t base, variable & output)
+	{
+		execute_switch(target_function, base, output);
+	}
+
+#endif
+
+#undef FRIDH_DISPATCH_STATE
+}
@@ -0,0 +1,32 @@
+#include <fridh/bytecode.hpp>
+
+namespace fridh
+{
+	instruction::instruction():
+		operation(opcode::return_nil),
+		a(0),
+		b(0),
+		c(0)
+	{
+	}
+
+	instruction::instruction(opcode::type operation, boost::uint32_t a, boost::uint32_t b, boost::uint32_t c):
+		operation(operation),
+		a(a),
+		b(b),
+		c(c)
+	{
+	}
+
+	bytecode_function::bytecode_function():
+		source(0),
+		argument_count(0),
+		register_count(0)
+	{
+	}
+
+	bytecode_program::bytecode_program():
+		entry_function(0)
+	{
+	}
+}
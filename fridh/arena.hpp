@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <ail/types.hpp>
+
+namespace fridh
+{
+	/*
+	Bump allocator which owns the parse tree and the executable units of a module.
+	Individual deallocations are no-ops, all the memory is released at once when the arena is destroyed.
+	The destructors of the objects still run when their owners release them, only the deallocations are saved.
+	Teardown therefore still visits every node: the vectors and the variable payloads inside the nodes live on the heap and have to be released one by one.
+	Arenas can't be copied since the objects they hold are referenced by their owners, they can only be swapped.
+	*/
+
+	class memory_arena
+	{
+	public:
+		static std::size_t const default_block_size = 64 * 1024;
+
+		memory_arena(std::size_t block_size = default_block_size);
+		~memory_arena();
+
+		void * allocate(std::size_t size);
+		void clear();
+		void swap(memory_arena & other);
+
+		uword get_allocation_count() const;
+		uword get_size() const;
+
+	private:
+		std::vector<char *> blocks;
+		char * current;
+		std::size_t remaining;
+		std::size_t block_size;
+		uword allocation_count;
+		uword size;
+
+		memory_arena(memory_arena const & other);
+		memory_arena & operator=(memory_arena const & other);
+	};
+
+	//makes an arena the target of the arena allocated types of the current thread until the scope is left
+	class arena_scope
+	{
+	public:
+		arena_scope(memory_arena & arena);
+		~arena_scope();
+
+	private:
+		memory_arena * previous_arena;
+
+		arena_scope(arena_scope const & other);
+		arena_scope & operator=(arena_scope const & other);
+	};
+
+	memory_arena * get_current_arena();
+
+	//allocations are tagged with their arena so objects created outside of an arena scope are still freed properly
+	void * arena_allocate(std::size_t size);
+	void arena_deallocate(void * pointer);
+}
+
+#define FRIDH_ARENA_ALLOCATED \
+	static void * operator new(std::size_t size) \
+	{ \
+		return fridh::arena_allocate(size); \
+	} \
+	\
+	static void operator delete(void * pointer) \
+	{ \
+		fridh::arena_deallocate(pointer); \
+	}
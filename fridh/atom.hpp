@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <ail/types.hpp>
+
+namespace fridh
+{
+	/*
+	Identifiers are interned in a table shared by all threads so every distinct name is stored once and can be compared and hashed as a 32-bit number.
+	Atoms are never released, the strings they refer to stay valid and unchanged until the program exits.
+	Only adding a new name takes a lock, looking up names which have already been interned and the strings of atoms doesn't.
+	*/
+
+	typedef boost::uint32_t atom;
+	typedef std::vector<atom> atom_vector;
+
+	atom get_atom(std::string const & name);
+	atom get_atom(char const * name, std::size_t size);
+	std::string const & get_atom_string(atom input);
+
+	uword get_atom_count();
+}
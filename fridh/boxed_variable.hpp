@@ -0,0 +1,141 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <boost/cstdint.hpp>
+#include <fridh/symbol.hpp>
+
+namespace fridh
+{
+	class boxed_variable;
+
+	namespace types
+	{
+		typedef std::vector<boxed_variable> boxed_vector;
+		typedef std::map<boxed_variable, boxed_variable> boxed_map;
+	}
+
+	/*
+	NaN-boxed alternative to variable which fits into 64 bits.
+	Doubles are stored as they are, with every NaN being replaced by a single canonical quiet NaN.
+	All other values are stored as negative quiet NaNs: the upper 16 bits hold the tag, the lower 48 bits the payload.
+	Integers which do not fit into 48 bits are kept on the heap.
+	Strings, arrays and maps are shared payloads just like in variable, copies share them until one of them gets modified.
+	Strings even share their payload with the variables they are converted from or to.
+	*/
+
+	class boxed_variable
+	{
+	public:
+		boxed_variable();
+		boxed_variable(boxed_variable const & other);
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+		boxed_variable(boxed_variable && other) BOOST_NOEXCEPT;
+#endif
+		explicit boxed_variable(variable const & other);
+		~boxed_variable();
+
+		variable_type get_type() const;
+
+		void nil();
+		void none();
+		void new_boolean(types::boolean new_boolean);
+		void new_signed_integer(types::signed_integer new_signed_integer);
+		void new_unsigned_integer(types::unsigned_integer new_unsigned_integer);
+		void new_floating_point_value(types::floating_point_value new_floating_point_value);
+		void new_string(types::string const & new_string);
+		void new_array();
+		void new_map();
+		void new_function(function * new_function_pointer);
+
+		types::boolean get_boolean() const;
+		types::signed_integer get_signed_integer() const;
+		types::unsigned_integer get_unsigned_integer() const;
+		types::floating_point_value get_floating_point_value() const;
+		types::string const & get_string() const;
+		types::boxed_vector & get_array();
+		types::boxed_vector const & get_array() const;
+		function * get_function() const;
+
+		std::string get_string_representation() const;
+		bool get_boolean_value() const;
+
+		void to_variable(variable & output) const;
+		void from_variable(variable const & input);
+
+#define DECLARE_UNARY_OPERATOR(name) void name(boxed_variable & output) const;
+#define DECLARE_BINARY_OPERATOR(name) void name(boxed_variable const & argument, boxed_variable & output) const;
+
+		DECLARE_BINARY_OPERATOR(addition)
+		DECLARE_BINARY_OPERATOR(subtraction)
+		DECLARE_BINARY_OPERATOR(multiplication)
+		DECLARE_BINARY_OPERATOR(division)
+		DECLARE_BINARY_OPERATOR(modulo)
+
+		DECLARE_BINARY_OPERATOR(less_than)
+		DECLARE_BINARY_OPERATOR(less_than_or_equal)
+		DECLARE_BINARY_OPERATOR(greater_than)
+		DECLARE_BINARY_OPERATOR(greater_than_or_equal)
+		DECLARE_BINARY_OPERATOR(not_equal)
+		DECLARE_BINARY_OPERATOR(equal)
+
+		DECLARE_UNARY_OPERATOR(logical_not)
+
+		DECLARE_BINARY_OPERATOR(logical_and)
+		DECLARE_BINARY_OPERATOR(logical_or)
+
+		DECLARE_BINARY_OPERATOR(shift_left)
+		DECLARE_BINARY_OPERATOR(shift_right)
+
+		DECLARE_BINARY_OPERATOR(binary_and)
+		DECLARE_BINARY_OPERATOR(binary_or)
+		DECLARE_BINARY_OPERATOR(binary_xor)
+
+		DECLARE_UNARY_OPERATOR(binary_not)
+
+		DECLARE_UNARY_OPERATOR(negation)
+
+#undef DECLARE_UNARY_OPERATOR
+#undef DECLARE_BINARY_OPERATOR
+
+		bool operator==(boxed_variable const & other) const;
+		bool operator!=(boxed_variable const & other) const;
+		bool operator<(boxed_variable const & other) const;
+
+		boxed_variable & operator=(boxed_variable const & other);
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+		boxed_variable & operator=(boxed_variable && other) BOOST_NOEXCEPT;
+#endif
+
+		void copy(boxed_variable const & other);
+		void move(boxed_variable & other) BOOST_NOEXCEPT;
+		void destroy();
+		void swap(boxed_variable & other) BOOST_NOEXCEPT;
+
+	private:
+		struct heap_integer
+		{
+			variable_type type;
+			types::unsigned_integer value;
+		};
+
+		boost::uint64_t bits;
+
+		boost::uint64_t get_tag() const;
+		boost::uint64_t get_payload() const;
+		void * get_pointer() const;
+		void set(boost::uint64_t tag, boost::uint64_t payload);
+		void set_pointer(boost::uint64_t tag, void * pointer);
+		void set_integer(variable_type type, types::unsigned_integer value);
+
+		shared_payload<types::string> * get_string_payload() const;
+		shared_payload<types::boxed_vector> * get_array_payload() const;
+		shared_payload<types::boxed_map> * get_map_payload() const;
+
+		bool is_floating_point_value() const;
+		bool is_small_signed_integer() const;
+		types::signed_integer get_small_signed_integer() const;
+		types::floating_point_value get_double() const;
+	};
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <boost/cstdint.hpp>
+#include <ail/types.hpp>
+#include <fridh/symbol.hpp>
+#include <fridh/interpreter.hpp>
+
+namespace fridh
+{
+	namespace opcode
+	{
+		enum type
+		{
+			//a = b
+			move,
+			//a = constants[b]
+			load_constant,
+			//a = functions[b]
+			load_function,
+
+			//a = operator b
+			negation,
+			logical_not,
+			binary_not,
+
+			//a = a + 1, a = a - 1
+			increment,
+			decrement,
+
+			//a = b operator c
+			addition,
+			subtraction,
+			multiplication,
+			division,
+			modulo,
+
+			less_than,
+			less_than_or_equal,
+			greater_than,
+			greater_than_or_equal,
+			not_equal,
+			equal,
+
+			logical_and,
+			logical_or,
+
+			shift_left,
+			shift_right,
+
+			binary_and,
+			binary_or,
+			binary_xor,
+
+			//a = array of the c registers starting at b
+			new_array,
+
+			//jump to a
+			jump,
+			//jump to b if a is true/false
+			jump_if_true,
+			jump_if_false,
+
+			//a = result of calling functions[c] with the arguments starting at b
+			call_direct,
+			//a = result of calling the function in b with the c arguments starting at b + 1
+			call,
+
+			//b + 1 = element b of array a, b = b + 1, jump to c at the end of the array
+			for_each_next,
+
+			//return a
+			return_value,
+			//return nil
+			return_nil,
+		};
+	}
+
+	struct instruction
+	{
+		opcode::type operation;
+		boost::uint32_t
+			a,
+			b,
+			c;
+
+		instruction();
+		instruction(opcode::type operation, boost::uint32_t a = 0, boost::uint32_t b = 0, boost::uint32_t c = 0);
+	};
+
+	typedef std::vector<instruction> instructions;
+
+	namespace dispatch_method
+	{
+		enum type
+		{
+			switch_dispatch,
+			direct_threading,
+		};
+	}
+
+	//computed goto dispatch requires the labels as values extension of GCC, define FRIDH_SWITCH_DISPATCH to use the portable switch loop by default
+#if defined(__GNUC__)
+#define FRIDH_HAS_COMPUTED_GOTO
+#endif
+
+#if defined(FRIDH_HAS_COMPUTED_GOTO) && !defined(FRIDH_SWITCH_DISPATCH)
+	dispatch_method::type const default_dispatch_method = dispatch_method::direct_threading;
+#else
+	dispatch_method::type const default_dispatch_method = dispatch_method::switch_dispatch;
+#endif
+
+	struct bytecode_function
+	{
+		std::string name;
+		function * source;
+		uword
+			argument_count,
+			register_count;
+		instructions code;
+
+		bytecode_function();
+	};
+
+	struct bytecode_program
+	{
+		std::vector<bytecode_function> functions;
+		std::vector<variable> constants;
+		std::map<function *, uword> function_indices;
+		uword entry_function;
+
+		bytecode_program();
+	};
+
+	class bytecode_compiler
+	{
+	public:
+		bytecode_compiler();
+
+		bool compile(module & target_module, bytecode_program & output, std::string & error_message);
+
+	private:
+		bytecode_program * program;
+
+		bytecode_function * current_function;
+		std::vector<uword> iterator_registers;
+		uword
+			next_register,
+			maximum_register;
+
+		void add_functions(symbol_tree_node & node, std::string const & name, std::vector<symbol_tree_node *> & nodes);
+		void compile_function(function & source, bytecode_function & output);
+
+		uword allocate_register();
+		uword get_offset() const;
+		uword emit(opcode::type operation, uword a = 0, uword b = 0, uword c = 0);
+		void patch(uword offset, uword target);
+		uword add_constant(variable const & constant);
+
+		void compile_units(executable_units const & units);
+		void compile_unit(executable_unit const & unit);
+		void compile_loop(parse_tree_node const & conditional, executable_units const & body, parse_tree_node const * iteration);
+		void compile_for_each(for_each_statement const & statement);
+
+		uword compile_operand(parse_tree_node const & node);
+		void compile_expression(parse_tree_node const & node, uword target);
+		void compile_symbol(parse_tree_symbol const & symbol, uword target);
+		void compile_unary_operator(parse_tree_unary_operator_node const & node, uword target);
+		void compile_binary_operator(parse_tree_binary_operator_node const & node, uword target);
+		void compile_assignment(parse_tree_binary_operator_node const & node, uword target);
+		void compile_call(parse_tree_call const & call, uword target);
+		void compile_array(parse_tree_array const & array, uword target);
+
+		uword get_local(parse_tree_node const & node);
+	};
+
+	class virtual_machine
+	{
+	public:
+		virtual_machine(dispatch_method::type method = default_dispatch_method);
+
+		bool run(bytecode_program const & program, variable & output, std::string & error_message);
+		execution_statistics const & get_statistics() const;
+
+	private:
+		dispatch_method::type method;
+		bytecode_program const * program;
+		std::vector<variable> registers;
+		execution_statistics statistics;
+
+		void call_function(uword function_index, std::size_t base, variable & output);
+		void execute(bytecode_function const & target_function, std::size_t base, variable & output);
+		void execute_switch(bytecode_function const & target_function, std::size_t base, variable & output);
+		void execute_threaded(bytecode_function const & target_function, std::size_t base, variable & output);
+	};
+
+	std::string get_opcode_string(opcode::type operation);
+	std::string disassemble(bytecode_program const & program);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <ail/types.hpp>
+#include <fridh/symbol.hpp>
+
+namespace fridh
+{
+	/*
+	On-disk cache of parsed modules so unchanged sources don't have to be lexed and parsed again.
+	The files are named after the FNV-1a hash of the source code, their header repeats the hash and the size of the source along with the format version.
+	Files which don't match are ignored and get replaced by the next store.
+	*/
+
+	class module_cache
+	{
+	public:
+		//must be incremented whenever the serialised trees change
+		static uword const format_version = 2;
+
+		module_cache(std::string const & directory);
+
+		//the cache files are mapped into memory, a failed load leaves the output untouched
+		bool load(char const * source, std::size_t source_size, module & output) const;
+		bool store(char const * source, std::size_t source_size, module const & input) const;
+
+		std::string get_path(char const * source, std::size_t source_size) const;
+
+	private:
+		std::string directory;
+
+		std::string get_path(uword hash) const;
+	};
+
+	uword get_source_hash(char const * data, std::size_t size);
+
+	/*
+	The trees are stored in their flat form (see flat.hpp): the characters of the string table are followed by the arrays, each of them preceded by its size.
+	All numbers are stored in the byte order of the host, the header records it along with the word size so caches of other platforms are rejected.
+	*/
+
+	bool serialise_module(module const & input, uword source_hash, uword source_size, std::string & output);
+	bool deserialise_module(char const * data, std::size_t size, uword source_hash, uword source_size, module & output);
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+#include <boost/config.hpp>
 #include <ail/exception.hpp>
 
 namespace fridh
@@ -7,12 +9,29 @@ namespace fridh
 	struct construction_pattern
 	{
 		virtual void copy(construction_pattern const & other);
+		//takes over the resources of the other object and leaves it in the destroyed state
+		virtual void move(construction_pattern & other);
 		virtual void destroy();
 
 		construction_pattern();
 		construction_pattern(construction_pattern const & other);
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+		construction_pattern(construction_pattern && other);
+#endif
 		~construction_pattern();
 
 		construction_pattern & operator=(construction_pattern const & other);
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+		construction_pattern & operator=(construction_pattern && other);
+#endif
 	};
+
+	//appends an element to a vector without copying it, the element is left in the destroyed state
+	//this also works without rvalue references as long as the type provides swap
+	template<typename type>
+	void move_back(std::vector<type> & container, type & element)
+	{
+		container.push_back(type());
+		container.back().swap(element);
+	}
 }
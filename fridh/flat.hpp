@@ -0,0 +1,178 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <ail/types.hpp>
+#include <fridh/symbol.hpp>
+
+namespace fridh
+{
+	/*
+	Alternative representation of the trees of a module: the nodes of each kind are stored in a contiguous array and refer to each other by 32-bit indices instead of owning pointers.
+	Siblings (the arguments of a call, the elements of an array, the units of a body and the children of a symbol) are stored next to each other and are referenced as a range.
+	Parents always precede their children so walking the trees reads the arrays from the front to the back.
+	The elements only consist of fixed size numbers so the arrays can be written to disk as they are, the enumerations are stored as 32-bit numbers for that reason.
+	*/
+
+	typedef boost::uint32_t flat_index;
+
+	struct flat_range
+	{
+		flat_index
+			offset,
+			size;
+	};
+
+	//the index refers to the array of the type of the node, it's unused for the types without any members (e.g. iterators)
+	struct flat_node
+	{
+		boost::uint32_t type;
+		flat_index index;
+	};
+
+	//booleans are stored as unsigned integers and strings by the index of their string
+	struct flat_constant
+	{
+		boost::uint32_t
+			type,
+			reserved;
+
+		union
+		{
+			boost::int64_t signed_integer;
+			boost::uint64_t unsigned_integer;
+			types::floating_point_value floating_point_value;
+		};
+	};
+
+	struct flat_symbol
+	{
+		flat_index name;
+		boost::uint32_t type;
+	};
+
+	struct flat_unary_operator_node
+	{
+		boost::uint32_t type;
+		flat_index argument;
+	};
+
+	struct flat_binary_operator_node
+	{
+		boost::uint32_t type;
+		flat_index
+			left_argument,
+			right_argument;
+	};
+
+	struct flat_call
+	{
+		flat_index function;
+		flat_range arguments;
+	};
+
+	//the index of a statement refers to a node, the others refer to the array of their type
+	struct flat_unit
+	{
+		boost::uint32_t type;
+		flat_index index;
+	};
+
+	struct flat_if_statement
+	{
+		flat_index conditional_term;
+		flat_range body;
+	};
+
+	struct flat_if_else_statement
+	{
+		flat_index conditional_term;
+		flat_range
+			if_body,
+			else_body;
+	};
+
+	struct flat_for_each_statement
+	{
+		flat_index container;
+		flat_range body;
+	};
+
+	struct flat_for_statement
+	{
+		flat_index
+			initialisation,
+			conditional,
+			iteration;
+		flat_range body;
+	};
+
+	struct flat_while_statement
+	{
+		flat_index conditional_term;
+		flat_range body;
+	};
+
+	//the arguments are a range of the argument names, which are indices of strings
+	struct flat_function
+	{
+		flat_range
+			arguments,
+			body;
+	};
+
+	//the member is the index of the function or the index of the name of the class
+	struct flat_symbol_tree_node
+	{
+		boost::uint32_t type;
+		flat_index
+			name,
+			member;
+		flat_range children;
+	};
+
+	struct flat_module
+	{
+		//the root of the symbol tree and the entry function come first
+		std::vector<flat_symbol_tree_node> symbol_tree_nodes;
+		std::vector<flat_function> functions;
+		std::vector<flat_index> argument_names;
+
+		std::vector<flat_unit> units;
+		std::vector<flat_if_statement> if_statements;
+		std::vector<flat_if_else_statement> if_else_statements;
+		std::vector<flat_for_each_statement> for_each_statements;
+		std::vector<flat_for_statement> for_statements;
+		std::vector<flat_while_statement> while_statements;
+
+		std::vector<flat_node> nodes;
+		std::vector<flat_constant> constants;
+		std::vector<flat_symbol> symbols;
+		std::vector<flat_unary_operator_node> unary_operator_nodes;
+		std::vector<flat_binary_operator_node> binary_operator_nodes;
+		std::vector<flat_call> calls;
+		std::vector<flat_range> arrays;
+
+		//every distinct string is stored once, the ranges refer to the characters
+		std::vector<flat_range> strings;
+		std::string characters;
+
+		void clear();
+
+		std::string get_string(flat_index index) const;
+		void get_constant(flat_index index, variable & output) const;
+
+		//same output as parse_tree_node::to_string except that symbols are identified by their index
+		std::string to_string(flat_index node) const;
+	};
+
+	//throws if the module contains something which can't be represented, e.g. variables other than the literals of the parser
+	void flatten_module(module const & input, flat_module & output);
+
+	/*
+	Builds the regular trees in the arena of the output, which is only modified if the entire flat module is valid.
+	Every index is checked and every node may only be referenced once so corrupted input results in an exception rather than a crash.
+	*/
+	void expand_module(flat_module const & input, module & output);
+}
@@ -5,7 +5,9 @@
 
 #include <ail/types.hpp>
 
+#include <fridh/atom.hpp>
 #include <fridh/construction.hpp>
+#include <fridh/arena.hpp>
 
 namespace fridh
 {
@@ -111,6 +113,7 @@ namespace fridh
 	struct parse_tree_node;
 	struct parse_tree_symbol;
 	struct executable_unit;
+	struct symbol_tree_node;
 
 	typedef std::vector<parse_tree_node> parse_tree_nodes;
 	typedef std::vector<parse_tree_symbol> parse_tree_symbols;
@@ -138,12 +141,20 @@ namespace fridh
 
 		parse_tree_node();
 		parse_tree_node(parse_tree_node const & other);
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+		parse_tree_node(parse_tree_node && other) BOOST_NOEXCEPT;
+#endif
 		~parse_tree_node();
 
 		parse_tree_node & operator=(parse_tree_node const & other);
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+		parse_tree_node & operator=(parse_tree_node && other) BOOST_NOEXCEPT;
+#endif
 
 		void copy(parse_tree_node const & other);
+		void move(parse_tree_node & other) BOOST_NOEXCEPT;
 		void destroy();
+		void swap(parse_tree_node & other) BOOST_NOEXCEPT;
 
 		parse_tree_node(parse_tree_node_type::type type);
 		parse_tree_node(variable * variable_pointer);
@@ -155,20 +166,33 @@ namespace fridh
 		bool is_post_fix() const;
 		std::string to_string() const;
 		bool is_call_node() const;
+
+		FRIDH_ARENA_ALLOCATED
 	};
 
 	struct parse_tree_symbol
 	{
-		std::string name;
+		//marks symbols which don't refer to a local variable
+		static uword const no_slot = ~static_cast<uword>(0);
+
+		atom name;
 		symbol_prefix::type type;
 
+		//set by the resolver: the local variable of the function and the function the name refers to otherwise
+		uword slot;
+		symbol_tree_node * function_node;
+
 		parse_tree_symbol();
+
+		FRIDH_ARENA_ALLOCATED
 	};
 
 	struct parse_tree_unary_operator_node
 	{
 		unary_operator_type::type type;
 		parse_tree_node argument;
+
+		FRIDH_ARENA_ALLOCATED
 	};
 
 	struct parse_tree_binary_operator_node
@@ -177,23 +201,31 @@ namespace fridh
 		parse_tree_node
 			left_argument,
 			right_argument;
+
+		FRIDH_ARENA_ALLOCATED
 	};
 
 	struct parse_tree_call
 	{
 		parse_tree_node function;
 		parse_tree_nodes arguments;
+
+		FRIDH_ARENA_ALLOCATED
 	};
 
 	struct parse_tree_array
 	{
 		parse_tree_nodes elements;
+
+		FRIDH_ARENA_ALLOCATED
 	};
 
 	struct if_statement
 	{
 		parse_tree_node conditional_term;
 		executable_units body;
+
+		FRIDH_ARENA_ALLOCATED
 	};
 
 	struct if_else_statement
@@ -202,12 +234,16 @@ namespace fridh
 		executable_units
 			if_body,
 			else_body;
+
+		FRIDH_ARENA_ALLOCATED
 	};
 
 	struct for_each_statement
 	{
 		parse_tree_node container;
 		executable_units body;
+
+		FRIDH_ARENA_ALLOCATED
 	};
 
 	struct for_statement
@@ -217,12 +253,16 @@ namespace fridh
 			conditional,
 			iteration;
 		executable_units body;
+
+		FRIDH_ARENA_ALLOCATED
 	};
 
 	struct while_statement
 	{
 		parse_tree_node conditional_term;
 		executable_units body;
+
+		FRIDH_ARENA_ALLOCATED
 	};
 
 	struct executable_unit
@@ -241,17 +281,30 @@ namespace fridh
 
 		executable_unit();
 		executable_unit(executable_unit const & other);
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+		executable_unit(executable_unit && other) BOOST_NOEXCEPT;
+#endif
 		~executable_unit();
 
 		executable_unit & operator=(executable_unit const & other);
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+		executable_unit & operator=(executable_unit && other) BOOST_NOEXCEPT;
+#endif
 		
 		void copy(executable_unit const & other);
+		void move(executable_unit & other) BOOST_NOEXCEPT;
 		void destroy();
+		void swap(executable_unit & other) BOOST_NOEXCEPT;
 	};
 
 	struct function
 	{
-		string_vector arguments;
+		atom_vector arguments;
 		executable_units body;
+
+		//set by the resolver, the arguments occupy the first slots
+		uword local_count;
+
+		function();
 	};
 }
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <ail/types.hpp>
+#include <fridh/symbol.hpp>
+#include <fridh/parser.hpp>
+
+namespace fridh
+{
+	/*
+	Keeps a module up to date while its source code is being edited so reloading it only costs as much as the edit.
+	The source is split into top-level blocks, i.e. a line without any indentation along with the indented lines following it.
+	Blocks which are also found in the previous version of the source keep their symbols and units, only the others are lexed and parsed again.
+	The nodes of the replaced blocks stay in the arena of the module until they make up half of it, then the entire module is parsed again.
+	*/
+
+	class incremental_parser
+	{
+	public:
+		//the module must be empty and may only be modified by this parser
+		incremental_parser(std::string const & name, module & output);
+
+		//a failed update leaves the module untouched
+		bool process_module(std::string const & path, std::string & error_message);
+		bool process_data(char const * data, std::size_t size, std::string & error_message);
+
+		std::size_t get_block_count() const;
+		//number of blocks which had to be parsed by the last update
+		std::size_t get_parsed_block_count() const;
+
+	private:
+		struct block
+		{
+			uword hash;
+			std::size_t
+				offset,
+				size;
+			uword first_line;
+
+			//top-level functions and classes declared by the block
+			atom_vector names;
+			std::size_t unit_count;
+			//memory the nodes of the block take up in the arena of the module
+			uword arena_size;
+
+			block();
+		};
+
+		typedef std::vector<block> block_vector;
+
+		std::string name;
+		module & output;
+		parser block_parser;
+
+		std::string source;
+		block_vector blocks;
+		std::size_t parsed_block_count;
+		uword garbage_size;
+
+		bool update(char const * data, std::size_t size, module & target, std::string & error_message);
+		void compact();
+	};
+}
@@ -2,16 +2,60 @@
 
 #include <string>
 #include <vector>
+#include <ail/types.hpp>
+#include <fridh/symbol.hpp>
 
 namespace fridh
 {
+	struct execution_statistics
+	{
+		uword instructions;
+		uword microseconds;
+
+		execution_statistics();
+
+		std::string to_string() const;
+	};
 
 	class interpreter
 	{
 	public:
 		interpreter();
 
+		bool run(module & target_module, variable & output, std::string & error_message);
+		execution_statistics const & get_statistics() const;
+
 	private:
+		struct call_frame
+		{
+			//indexed by the slots of the resolver, variables which haven't been assigned yet are undefined
+			std::vector<variable> locals;
+			std::vector<variable const *> iterators;
+			variable return_value;
+
+			call_frame(uword local_count);
+		};
+
 		bool running;
+
+		execution_statistics statistics;
+		call_frame * current_frame;
+
+		void call_function(function & target, std::vector<variable> & arguments, variable & output);
+
+		bool execute_units(executable_units const & units);
+		bool execute_unit(executable_unit const & unit);
+		bool execute_for_each(for_each_statement const & statement);
+
+		void evaluate(parse_tree_node const & input, variable & output);
+		void evaluate_symbol(parse_tree_symbol const & symbol, variable & output);
+		void evaluate_unary_operator(parse_tree_unary_operator_node const & node, variable & output);
+		void evaluate_binary_operator(parse_tree_binary_operator_node const & node, variable & output);
+		void evaluate_assignment(parse_tree_binary_operator_node const & node, variable & output);
+		void evaluate_call(parse_tree_call const & call, variable & output);
+		void evaluate_array(parse_tree_array const & array, variable & output);
+
+		variable & get_assignment_target(parse_tree_node const & target);
+		bool get_condition(parse_tree_node const & conditional);
 	};
 }
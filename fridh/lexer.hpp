@@ -1,11 +1,13 @@
 #pragma once
 
+#include <iosfwd>
 #include <string>
 #include <vector>
 #include <ail/types.hpp>
+#include <boost/cstdint.hpp>
 #include <fridh/symbol.hpp>
 #include <fridh/construction.hpp>
-#include <boost/thread/mutex.hpp>
+#include <fridh/scan.hpp>
 
 namespace fridh
 {
@@ -118,7 +120,11 @@ namespace fridh
 
 	struct lexeme
 	{
+		static boost::uint32_t const owned_string = 0xffffffff;
+
 		lexeme_type::type type;
+		//length of the source text referenced by strings which are views, owned_string otherwise
+		boost::uint32_t view_length;
 		union
 		{
 			bool boolean;
@@ -126,27 +132,41 @@ namespace fridh
 			types::unsigned_integer unsigned_integer;
 			types::floating_point_value floating_point_value;
 			std::string * string;
+			char const * view;
+			//names are interned by the lexer
+			atom name;
 		};
 
 		lexeme();
 		lexeme(lexeme const & other);
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+		lexeme(lexeme && other) BOOST_NOEXCEPT;
+#endif
 		lexeme(lexeme_type::type type);
 		explicit lexeme(types::boolean boolean);
 		explicit lexeme(types::signed_integer signed_integer);
 		explicit lexeme(types::unsigned_integer unsigned_integer);
 		explicit lexeme(types::floating_point_value floating_point_value);
 		explicit lexeme(std::string const & string);
+		lexeme(lexeme_type::type type, char const * view, std::size_t view_length);
 
 		~lexeme();
 
 		std::string to_string() const;
 
 		lexeme & operator=(lexeme const & other);
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+		lexeme & operator=(lexeme && other) BOOST_NOEXCEPT;
+#endif
 
 		void copy(lexeme const & other);
+		void move(lexeme & other) BOOST_NOEXCEPT;
 		void destroy();
+		void swap(lexeme & other) BOOST_NOEXCEPT;
 
 		bool is_string() const;
+		bool is_view() const;
+		std::string get_string() const;
 	};
 
 	struct line_of_code
@@ -156,6 +176,7 @@ namespace fridh
 		lexeme_container lexemes;
 
 		line_of_code();
+		void swap(line_of_code & other);
 	};
 
 	struct operator_lexeme
@@ -167,15 +188,70 @@ namespace fridh
 		bool operator<(operator_lexeme const & other) const;
 	};
 
+	//state of the automaton which matches operators, a transition to 0 (the initial state) means that there is no match
+	struct operator_state
+	{
+		boost::uint8_t transitions[0x100];
+		bool accepting;
+		lexeme_type::type lexeme;
+
+		operator_state();
+	};
+
+	//comments which span lines and may still be open at the end of a chunk
+	namespace comment_type
+	{
+		enum type
+		{
+			none,
+			multi_line,
+			nested
+		};
+	}
+
+	//receives the lines of a streaming lexer as soon as they are complete, the lexemes may be swapped out of the line
+	class line_consumer
+	{
+	public:
+		virtual ~line_consumer();
+		virtual void consume(line_of_code & line) = 0;
+	};
+
 	class lexer
 	{
 	public:
-		lexer(std::string const & input, lines_of_code & lines);
+		static std::size_t const default_chunk_size = 64 * 1024;
+
+		//with use_views strings without escape sequences reference the input, which must then outlive the lines
+		lexer(std::string const & input, lines_of_code & lines, bool use_views = false);
+		lexer(char const * input, std::size_t input_size, lines_of_code & lines, bool use_views = false);
+		//the entire input is available but the lines are handed to the consumer as soon as they are complete
+		lexer(char const * input, std::size_t input_size, line_consumer & consumer, bool use_views = false);
 		bool parse(std::string & error);
 
+		/*
+		Streaming mode: the input is passed in chunks of arbitrary size and completed lines are handed to the consumer.
+		Only the incomplete last line is kept in the buffer, a comment spanning several chunks is continued where the previous chunk ended.
+		*/
+		lexer(line_consumer & consumer);
+		bool feed(char const * data, std::size_t size, std::string & error);
+		bool feed(std::istream & stream, std::string & error, std::size_t chunk_size = default_chunk_size);
+		bool finish(std::string & error);
+
+		//for parts of a module, the line numbers of the lines and the error messages start at the given line, it must be set before the input is lexed
+		void set_first_line(uword new_first_line);
+
 	private:
-		std::string const & input;
+		std::string buffer;
+		lines_of_code buffered_lines;
+
+		char const * input;
+		std::size_t input_size;
 		lines_of_code & lines;
+		bool use_views;
+		line_consumer * consumer;
+		bool more_input;
+		uword first_line;
 
 		uword line;
 		std::size_t
@@ -183,21 +259,32 @@ namespace fridh
 			end,
 			line_offset;
 		line_of_code current_line;
+		scan_kernels const * kernels;
+
+		comment_type::type open_comment;
+		uword
+			comment_depth,
+			comment_line;
 
 		bool parse_operator(line_of_code & output);
 		void parse_string(line_of_code & output);
 		bool parse_number(line_of_code & output);
 		void parse_name(line_of_code & output);
-		void parse_comment();
+		bool parse_comment();
+		bool parse_open_comment();
 
 		void lexer_error(std::string const & message, uword error_line = 0);
 		void number_parsing_error(std::string const & message);
 
-		bool is_name_char(char input);
 		bool string_match(std::string const & target);
 		void process_newline(bool next_line = true);
+		void add_current_line();
 
+		void initialise();
 		void parse_lexemes();
+		bool parse_range();
+		void process_chunks();
+		void flush_lines();
 
 		void process_one_liner(word summand);
 	};
@@ -208,6 +295,6 @@ namespace fridh
 
 	bool get_lexeme_group(lexeme_type::type input, lexeme_group::type & output);
 
-	extern boost::mutex table_mutex;
 	extern std::vector<operator_lexeme> operator_lexeme_data;
+	extern std::vector<operator_state> operator_states;
 }
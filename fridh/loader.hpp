@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <vector>
+#include <ail/types.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <fridh/symbol.hpp>
+#include <fridh/parser.hpp>
+
+namespace fridh
+{
+	struct module_load_result
+	{
+		std::string path;
+		//null if the module could not be loaded
+		boost::shared_ptr<module> loaded_module;
+		std::string error;
+		//time spent reading, lexing and parsing the module in microseconds
+		uword time;
+		std::size_t thread;
+
+		module_load_result();
+	};
+
+	/*
+	Loads independent modules in parallel, each worker thread uses a parser of its own.
+	The paths are distributed among the workers up front and idle workers steal from the others so a few big modules don't leave the rest of the threads waiting.
+	Big modules are only lexed on a pipeline thread of their own if there is a spare thread for every worker, so a load never runs more threads than the thread count.
+	*/
+
+	class module_loader
+	{
+	public:
+		//a thread count of 0 uses one thread per core, the cache is optional and shared by all the workers
+		module_loader(std::size_t thread_count = 0, module_cache const * cache = 0);
+
+		//the results are in the order of the paths, returns false if any of the modules failed to load
+		bool load(std::vector<std::string> const & paths, std::vector<module_load_result> & results);
+
+		//wall clock time of the last load in microseconds
+		uword get_time() const;
+
+	private:
+		struct work_queue
+		{
+			boost::mutex mutex;
+			std::deque<std::size_t> tasks;
+		};
+
+		std::size_t thread_count;
+		module_cache const * cache;
+		uword time;
+		bool use_pipelines;
+
+		std::vector<std::string> const * paths;
+		std::vector<module_load_result> * results;
+		std::vector<work_queue *> queues;
+
+		void work(std::size_t worker);
+		bool get_task(std::size_t worker, std::size_t & task);
+		void load_module(std::size_t task, std::size_t worker, parser & current_parser);
+	};
+}
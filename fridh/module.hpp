@@ -1,12 +1,22 @@
 #include <string>
 #include <fridh/function.hpp>
+#include <fridh/arena.hpp>
 
 namespace fridh
 {
 	struct module
 	{
+		//owns the parse tree, it must be declared first so it gets destroyed after the symbols and the entry function
+		memory_arena arena;
 		std::string path;
 		symbol_tree_node symbols;
 		function entry_function;
+
+		module();
+		//the parse tree of a copy is allocated in an arena of its own
+		module(module const & other);
+
+	private:
+		module & operator=(module const & other);
 	};
 }
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <fridh/symbol.hpp>
+
+namespace fridh
+{
+	/*
+	Evaluates the operators and array literals whose arguments are all constants ahead of time and replaces them with the resulting variable.
+	Operations which fail are left alone so their errors are still reported when they are executed.
+	Additions and subtractions of zero and multiplications and divisions by one are removed if the other argument is known to be a number which they leave unchanged.
+	The type of a local variable is only known if all of its assignments produce the same type and it has already been assigned by a preceding statement of its function.
+	Relies on the slots set by the resolver.
+	*/
+
+	void fold_constants(module & target_module);
+
+	/*
+	Removes the code which can never be executed or has no effect: branches and loops whose condition is a boolean or integer constant, the units following a return statement, an endless loop or a branch which returns either way, and statements which only read constants or arguments.
+	Dead code which check_units rejects is kept so the bytecode compiler still rejects the module.
+	Meant to be run after folding the constants, relies on the slots set by the resolver as well.
+	*/
+
+	void eliminate_dead_code(module & target_module);
+
+	/*
+	Resolves the module and runs all of the passes above on it, the interpreter and the bytecode compiler leave this to their callers.
+	The passes modify the parse tree so this is only meant for a module the caller has parsed for itself to execute it, not one which is still owned by an incremental parser or is going to be stored in a cache.
+	*/
+
+	void optimise_module(module & target_module);
+}
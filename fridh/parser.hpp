@@ -23,18 +23,35 @@ namespace fridh
 		std::size_t index;
 	};
 
+	class lexer_pipeline;
+	class module_cache;
+
 	class parser
 	{
 	public:
-		parser();
+		//modules of at least this size are lexed on a separate thread while they are being parsed
+		static std::size_t const default_pipeline_threshold = 1024 * 1024;
+		//a threshold which no module reaches, for callers which already keep all the cores busy
+		static std::size_t const no_pipeline = ~static_cast<std::size_t>(0);
+
+		parser(std::size_t pipeline_threshold = default_pipeline_threshold);
+
+		//modules are looked up in the cache before they are parsed and get stored in it afterwards, null disables the cache
+		void set_cache(module_cache const * new_cache);
+
 		bool process_module(std::string const & path, std::string const & name, module & output, std::string & error_message);
+		bool process_data(std::string const & data, std::string const & name, module & output, std::string & error_message);
+
+		//parses lines which have been lexed separately (e.g. a part of a module), the declarations are added to the symbols and the statements to the body
+		//the nodes are allocated in the arena of the current scope and the lines are consumed
+		bool process_lines(lines_of_code & input, std::string const & name, symbol_tree_node & symbols, executable_units & body, std::string & error_message);
 
 	private:
 		bool running;
+		std::size_t pipeline_threshold;
+		module_cache const * cache;
 
-		std::size_t
-			line_offset,
-			line_end;
+		std::size_t line_offset;
 
 		uword indentation_level;
 
@@ -45,15 +62,17 @@ namespace fridh
 		uword nested_class_level;
 
 		lines_of_code lines;
+		lexer_pipeline * pipeline;
 
 		symbol_tree_node * current_node;
 
-		bool name_is_used(std::string const & name);
-		std::string const & get_declaration_name();
+		bool name_is_used(atom name);
+		atom get_declaration_name();
 		void name_collision_check();
 		symbol_tree_node & add_name(symbol::type symbol_type);
 
 		void process_body(executable_units * output = 0, bool increment = true, bool is_anonymous_function = false);
+		void process_nested_body(executable_units & output);
 
 		void process_atomic_statement(lexeme_container & lexemes, std::size_t & offset, parse_tree_nodes & output, bool allow_multi_statements = false, lexeme_type::type terminator = lexeme_type::non_terminating_placeholder, bool allow_empty_statements = false);
 		void process_offset_atomic_statement(parse_tree_node & output, std::size_t offset = 0);
@@ -71,7 +90,9 @@ namespace fridh
 		void process_statement(executable_unit & output);
 		bool process_line(executable_unit * output = 0, bool is_anonymous_function = false);
 
-		bool translate_data(module & target_module, std::string const & data, std::string const & module_name, std::string & error_message_output);
+		bool translate_data(module & target_module, char const * data, std::size_t size, std::string const & module_name, std::string & error_message_output);
+		bool translate_lines(symbol_tree_node & symbols, executable_units & body, std::string const & module_name, std::string & error_message_output);
+		bool has_line(std::size_t offset);
 
 		lexeme_container & get_lexemes();
 
@@ -81,6 +102,10 @@ namespace fridh
 
 		void process_node_group(parse_tree_nodes & arguments, parse_tree_nodes & output);
 		void operator_resolution(parse_tree_nodes & input, parse_tree_node & output);
+		void resolve_expression(parse_tree_nodes & input, std::size_t & offset, word maximum_precedence, parse_tree_node & output);
+		void resolve_operand(parse_tree_nodes & input, std::size_t & offset, parse_tree_node & output);
+		void resolve_chain(parse_tree_nodes & input, std::size_t & offset, parse_tree_node & output);
+		void resolve_element(parse_tree_nodes & input, std::size_t & offset, parse_tree_node & output);
 
 		void scope_up();
 	};
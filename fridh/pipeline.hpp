@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <boost/atomic.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/lockfree/spsc_queue.hpp>
+#include <fridh/lexer.hpp>
+
+namespace fridh
+{
+	/*
+	Lexes a module on a separate thread while the parser processes the lines which have already been completed.
+	The lines are passed on in batches through a single producer/single consumer ring so neither side has to take a lock while the other one keeps up.
+	A side which finds the ring empty or full spins briefly and then sleeps until the other side has made progress.
+	The input must outlive the pipeline since the names and strings of the lines reference it.
+	*/
+
+	class lexer_pipeline: public line_consumer
+	{
+	public:
+		static std::size_t const batch_size = 256;
+		static std::size_t const ring_size = 64;
+		static unsigned const spin_limit = 64;
+
+		lexer_pipeline(char const * input, std::size_t input_size);
+		~lexer_pipeline();
+
+		//appends the next batch of lines to the output, blocks until one is available, returns false once all the lines have been pulled
+		bool pull(lines_of_code & output);
+		//discards the remaining lines and waits for the lexer, returns false with the error of the lexer if it failed
+		bool finish(std::string & error);
+
+		void consume(line_of_code & line);
+
+	private:
+		char const * input;
+		std::size_t input_size;
+
+		lines_of_code * batch;
+		boost::lockfree::spsc_queue<lines_of_code *, boost::lockfree::capacity<ring_size> > ring;
+		boost::atomic<bool> done;
+		//signalled whenever a batch has been pushed or popped and once the lexer is done
+		boost::mutex mutex;
+		boost::condition_variable ring_changed;
+		bool success;
+		std::string error;
+
+		//must be the last member so everything else has been initialised when the lexer starts
+		boost::thread thread;
+
+		void run();
+		void push_batch();
+		void notify();
+
+		lexer_pipeline(lexer_pipeline const & other);
+		lexer_pipeline & operator=(lexer_pipeline const & other);
+	};
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <fridh/symbol.hpp>
+
+namespace fridh
+{
+	/*
+	Binds the symbols of all functions of a module so they don't have to be looked up by name at run time.
+	Every name which is an argument or the target of an assignment within a function becomes a local variable with its own slot, the slots are numbered in the order of their first appearance.
+	The other names are resolved to the function they refer to in the scope of the function, if any.
+	Functions only see their own variables so the slots always refer to the frame of the current call.
+	*/
+
+	void resolve_module(module & target_module);
+
+	/*
+	Looks for the first construct which is rejected before any code is executed: a name which refers to neither a local variable nor a function, a call to a known function with the wrong number of arguments, an assignment to anything but a name, an iterator outside of a for each loop or an operator which hasn't been implemented yet.
+	The bytecode compiler reports these for the whole module while the interpreter only reports them once they are executed. The dead code eliminator keeps any code which contains them so it never makes the compiler accept a module it would have rejected.
+	Relies on the slots set by the resolver.
+	*/
+
+	bool check_units(executable_units const & units, bool in_for_each, std::string & error_message);
+	bool check_unit(executable_unit const & unit, bool in_for_each, std::string & error_message);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FRIDH_HAS_SIMD_SCAN
+#endif
+
+namespace fridh
+{
+	namespace scan_method
+	{
+		enum type
+		{
+			scalar,
+			sse2,
+			avx2
+		};
+	}
+
+	//kernels used by the lexer to skip runs of bytes, they all return the offset of the first byte at or after offset which ends the run, or end
+	struct scan_kernels
+	{
+		std::size_t (*skip_name_characters)(char const * data, std::size_t offset, std::size_t end);
+		std::size_t (*skip_spaces)(char const * data, std::size_t offset, std::size_t end);
+		std::size_t (*find_delimiter)(char const * data, std::size_t offset, std::size_t end, char first, char second, char third);
+	};
+
+	bool scan_method_is_supported(scan_method::type method);
+	scan_method::type get_best_scan_method();
+
+	//the best method supported by the CPU is selected by initialise_tables, setting another one initialises the tables first so it's kept
+	void set_scan_method(scan_method::type method);
+	//used by initialise_tables itself, doesn't check whether the CPU supports the method
+	void select_scan_method(scan_method::type method);
+	scan_method::type get_scan_method();
+	scan_kernels const & get_scan_kernels();
+
+	std::string get_scan_method_string(scan_method::type method);
+}
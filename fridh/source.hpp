@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace fridh
+{
+	/*
+	Read-only view of the source code of a module.
+	Regular files are mapped into memory so the lexer reads the page cache directly instead of a copy of the file.
+	Everything which can't be mapped (pipes, terminals, "-" for the standard input) is read into a string instead.
+	*/
+
+	class source_buffer
+	{
+	public:
+		source_buffer();
+		~source_buffer();
+
+		bool load(std::string const & path);
+		void clear();
+
+		char const * data() const;
+		std::size_t size() const;
+		bool is_mapped() const;
+
+	private:
+		char const * mapped_data;
+		std::size_t mapped_size;
+		std::string content;
+
+		bool read_descriptor(int descriptor);
+
+		source_buffer(source_buffer const & other);
+		source_buffer & operator=(source_buffer const & other);
+	};
+}
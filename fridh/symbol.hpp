@@ -1,7 +1,11 @@
 #pragma once
 
-#include <map>
+#include <cstddef>
 #include <string>
+#include <utility>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <fridh/atom.hpp>
 #include <fridh/construction.hpp>
 
 namespace fridh
@@ -25,7 +29,45 @@ namespace fridh
 
 	class variable;
 
-	typedef std::map<std::string, symbol_tree_node *> node_children;
+	/*
+	Children of a symbol keyed by the atoms of their names, they are iterated in the order in which they were added.
+	Small tables are searched linearly, larger ones get an open addressing index over the entries.
+	*/
+	class node_children
+	{
+	public:
+		typedef std::pair<atom, symbol_tree_node *> value_type;
+		typedef std::vector<value_type>::iterator iterator;
+		typedef std::vector<value_type>::const_iterator const_iterator;
+
+		iterator begin();
+		iterator end();
+		const_iterator begin() const;
+		const_iterator end() const;
+
+		std::size_t size() const;
+		bool empty() const;
+
+		iterator find(atom name);
+		const_iterator find(atom name) const;
+
+		//adds a null pointer for names which aren't in the table yet
+		symbol_tree_node * & operator[](atom name);
+
+		void erase(iterator position);
+		void clear();
+		void swap(node_children & other);
+
+	private:
+		std::vector<value_type> entries;
+		//indices of the entries plus one, zero marks an empty slot
+		std::vector<boost::uint32_t> slots;
+
+		std::size_t find_index(atom name) const;
+		void add_slot(std::size_t index);
+		void remove_slot(std::size_t index);
+		void rebuild_slots();
+	};
 
 	struct symbol_tree_node
 	{
@@ -50,8 +92,8 @@ namespace fridh
 		void copy(symbol_tree_node const & other);
 		void destroy();
 
-		bool exists(std::string const & name);
-		bool find_entity(std::string const & name, symbol_tree_node * & output);
+		bool exists(atom name);
+		bool find_entity(atom name, symbol_tree_node * & output);
 	};
 }
 
@@ -1,9 +1,11 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <boost/atomic.hpp>
 #include <ail/types.hpp>
 #include <ail/exception.hpp>
 #include <fridh/construction.hpp>
+#include <fridh/arena.hpp>
 
 namespace fridh
 {
@@ -43,11 +45,60 @@ namespace fridh
 		typedef std::map<variable, variable> map;
 	}
 
+	/*
+	Heap payload of strings, arrays and maps, shared by copies of a variable until one of them gets modified.
+	The count is atomic because payloads cross threads, e.g. the folded constant arrays of a module which is executed on several threads at once.
+	*/
+	template<typename type>
+	struct shared_payload
+	{
+		type data;
+		boost::atomic<uword> reference_count;
+
+		shared_payload():
+			reference_count(1)
+		{
+		}
+
+		shared_payload(type const & data):
+			data(data),
+			reference_count(1)
+		{
+		}
+	};
+
+	template<typename type>
+	void release_payload(shared_payload<type> * payload)
+	{
+		if(payload->reference_count.fetch_sub(1, boost::memory_order_release) == 1)
+		{
+			//the writes of the other owners must be visible before the payload is destroyed
+			boost::atomic_thread_fence(boost::memory_order_acquire);
+			delete payload;
+		}
+	}
+
+	//gives the caller a payload of its own before it gets modified
+	template<typename type>
+	void detach_payload(shared_payload<type> * & payload)
+	{
+		//a sole owner can't be joined by another one in the meantime since that would require a copy of the owning variable
+		if(payload->reference_count.load(boost::memory_order_acquire) == 1)
+			return;
+		shared_payload<type> * new_payload = new shared_payload<type>(payload->data);
+		//the other owners may have released the payload since the check
+		release_payload(payload);
+		payload = new_payload;
+	}
+
 	class variable
 	{
 	public:
 		variable();
 		variable(variable const & other);
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+		variable(variable && other) BOOST_NOEXCEPT;
+#endif
 		~variable();
 
 		variable_type get_type() const;
@@ -61,6 +112,19 @@ namespace fridh
 		void new_string(types::string const & new_string);
 		void new_array();
 		void new_map();
+		void new_function(function * new_function_pointer);
+
+		types::boolean get_boolean() const;
+		types::signed_integer get_signed_integer() const;
+		types::unsigned_integer get_unsigned_integer() const;
+		types::floating_point_value get_floating_point_value() const;
+		types::string const & get_string() const;
+		types::vector & get_array();
+		types::vector const & get_array() const;
+		function * get_function() const;
+
+		std::string get_string_representation() const;
+		bool get_boolean_value() const;
 
 #define DECLARE_UNARY_OPERATOR(name) void name(variable & output) const;
 #define DECLARE_BINARY_OPERATOR(name) void name(variable const & argument, variable & output) const;
@@ -104,11 +168,19 @@ namespace fridh
 		bool operator<(variable const & other) const;
 
 		variable & operator=(variable const & other);
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+		variable & operator=(variable && other) BOOST_NOEXCEPT;
+#endif
 
 		void copy(variable const & other);
+		void move(variable & other) BOOST_NOEXCEPT;
 		void destroy();
+		void swap(variable & other) BOOST_NOEXCEPT;
+
+		FRIDH_ARENA_ALLOCATED
 
 	private:
+		friend class boxed_variable;
 
 		union
 		{
@@ -116,9 +188,9 @@ namespace fridh
 			types::signed_integer signed_integer;
 			types::unsigned_integer unsigned_integer;
 			types::floating_point_value floating_point_value;
-			types::string * string;
-			types::vector * array;
-			types::map * map;
+			shared_payload<types::string> * string;
+			shared_payload<types::vector> * array;
+			shared_payload<types::map> * map;
 			function * function_pointer;
 			void * hash_pointer;
 		};
@@ -130,9 +202,7 @@ namespace fridh
 		bool is_numeric_type() const;
 		bool is_zero() const;
 
-		types::floating_point_value get_floating_point_value() const;
-		std::string get_string_representation() const;
-		bool get_boolean_value() const;
+		void make_unique();
 
 		bool array_addition(variable const & argument, variable & output) const;
 		bool string_addition(variable const & argument, variable & output) const;
@@ -0,0 +1,245 @@
+#include <fridh/interpreter.hpp>
+
+namespace fridh
+{
+	void interpreter::evaluate(parse_tree_node const & input, variable & output)
+	{
+		statistics.instructions++;
+
+		switch(input.type)
+		{
+			case parse_tree_node_type::variable:
+				output = *input.variable_pointer;
+				return;
+
+			case parse_tree_node_type::symbol:
+				evaluate_symbol(*input.symbol_pointer, output);
+				return;
+
+			case parse_tree_node_type::unary_operator_node:
+				evaluate_unary_operator(*input.unary_operator_pointer, output);
+				return;
+
+			case parse_tree_node_type::binary_operator_node:
+				evaluate_binary_operator(*input.binary_operator_pointer, output);
+				return;
+
+			case parse_tree_node_type::call:
+				evaluate_call(*input.call_pointer, output);
+				return;
+
+			case parse_tree_node_type::array:
+				evaluate_array(*input.array_pointer, output);
+				return;
+
+			case parse_tree_node_type::iterator:
+			{
+				std::vector<variable const *> & iterators = current_frame->iterators;
+				if(iterators.empty())
+					throw ail::exception("Encountered an iterator outside of a for each statement");
+				output = *iterators.back();
+				return;
+			}
+
+			default:
+				throw ail::exception("Unable to evaluate parse tree node of type " + input.to_string());
+		}
+	}
+
+	void interpreter::evaluate_symbol(parse_tree_symbol const & symbol, variable & output)
+	{
+		if(symbol.slot != parse_tree_symbol::no_slot)
+		{
+			variable & local = current_frame->locals[symbol.slot];
+			if(local.get_type() != variable_type_identifier::undefined)
+			{
+				output = local;
+				return;
+			}
+		}
+
+		if(symbol.function_node != 0)
+		{
+			output.new_function(symbol.function_node->function_pointer);
+			return;
+		}
+
+		throw ail::exception("Unknown symbol \"" + get_atom_string(symbol.name) + "\"");
+	}
+
+	variable & interpreter::get_assignment_target(parse_tree_node const & target)
+	{
+		//the resolver provides a slot for every symbol which is assigned to
+		if(target.type != parse_tree_node_type::symbol)
+			throw ail::exception("Assignments are only supported for symbols at this point");
+		return current_frame->locals[target.symbol_pointer->slot];
+	}
+
+	void interpreter::evaluate_unary_operator(parse_tree_unary_operator_node const & node, variable & output)
+	{
+		switch(node.type)
+		{
+			case unary_operator_type::increment:
+			case unary_operator_type::decrement:
+			{
+				variable & target = get_assignment_target(node.argument);
+				variable one, result;
+				one.new_signed_integer(1);
+				if(node.type == unary_operator_type::increment)
+					target.addition(one, result);
+				else
+					target.subtraction(one, result);
+				output = target;
+				target = result;
+				return;
+			}
+
+			default:
+				break;
+		}
+
+		variable argument;
+		evaluate(node.argument, argument);
+
+		switch(node.type)
+		{
+			case unary_operator_type::negation:
+				argument.negation(output);
+				break;
+
+			case unary_operator_type::logical_not:
+				argument.logical_not(output);
+				break;
+
+			case unary_operator_type::binary_not:
+				argument.binary_not(output);
+				break;
+
+			default:
+				throw ail::exception("Internal error: Invalid unary operator type encountered");
+		}
+	}
+
+	void interpreter::evaluate_assignment(parse_tree_binary_operator_node const & node, variable & output)
+	{
+		variable argument;
+		evaluate(node.right_argument, argument);
+
+		variable & target = get_assignment_target(node.left_argument);
+
+#define COMPOUND_ASSIGNMENT(type, operation) \
+			case binary_operator_type::type: \
+				target.operation(argument, output); \
+				break;
+
+		switch(node.type)
+		{
+			case binary_operator_type::assignment:
+				output = argument;
+				break;
+
+			COMPOUND_ASSIGNMENT(addition_assignment, addition)
+			COMPOUND_ASSIGNMENT(subtraction_assignment, subtraction)
+			COMPOUND_ASSIGNMENT(multiplication_assignment, multiplication)
+			COMPOUND_ASSIGNMENT(division_assignment, division)
+			COMPOUND_ASSIGNMENT(modulo_assignment, modulo)
+
+			case binary_operator_type::exponentiation_assignment:
+				throw ail::exception("Exponentiation has not been implemented yet");
+
+			default:
+				throw ail::exception("Internal error: Invalid assignment operator type encountered");
+		}
+
+#undef COMPOUND_ASSIGNMENT
+
+		target = output;
+	}
+
+	void interpreter::evaluate_binary_operator(parse_tree_binary_operator_node const & node, variable & output)
+	{
+		switch(node.type)
+		{
+			case binary_operator_type::assignment:
+			case binary_operator_type::addition_assignment:
+			case binary_operator_type::subtraction_assignment:
+			case binary_operator_type::multiplication_assignment:
+			case binary_operator_type::division_assignment:
+			case binary_operator_type::modulo_assignment:
+			case binary_operator_type::exponentiation_assignment:
+				evaluate_assignment(node, output);
+				return;
+
+			case binary_operator_type::selection:
+				throw ail::exception("Selection has not been implemented yet");
+
+			default:
+				break;
+		}
+
+		variable left, right;
+		evaluate(node.left_argument, left);
+		evaluate(node.right_argument, right);
+
+#define BINARY_OPERATION(type) \
+			case binary_operator_type::type: \
+				left.type(right, output); \
+				break;
+
+		switch(node.type)
+		{
+			BINARY_OPERATION(addition)
+			BINARY_OPERATION(subtraction)
+			BINARY_OPERATION(multiplication)
+			BINARY_OPERATION(division)
+			BINARY_OPERATION(modulo)
+
+			BINARY_OPERATION(less_than)
+			BINARY_OPERATION(less_than_or_equal)
+			BINARY_OPERATION(greater_than)
+			BINARY_OPERATION(greater_than_or_equal)
+			BINARY_OPERATION(not_equal)
+			BINARY_OPERATION(equal)
+
+			BINARY_OPERATION(logical_and)
+			BINARY_OPERATION(logical_or)
+
+			BINARY_OPERATION(shift_left)
+			BINARY_OPERATION(shift_right)
+
+			BINARY_OPERATION(binary_and)
+			BINARY_OPERATION(binary_or)
+			BINARY_OPERATION(binary_xor)
+
+			case binary_operator_type::exponentiation:
+				throw ail::exception("Exponentiation has not been implemented yet");
+
+			default:
+				throw ail::exception("Internal error: Invalid binary operator type encountered");
+		}
+
+#undef BINARY_OPERATION
+	}
+
+	void interpreter::evaluate_call(parse_tree_call const & call, variable & output)
+	{
+		variable function_variable;
+		evaluate(call.function, function_variable);
+		function * target = function_variable.get_function();
+
+		std::vector<variable> arguments(call.arguments.size());
+		for(std::size_t i = 0, end = arguments.size(); i < end; i++)
+			evaluate(call.arguments[i], arguments[i]);
+
+		call_function(*target, arguments, output);
+	}
+
+	void interpreter::evaluate_array(parse_tree_array const & array, variable & output)
+	{
+		output.new_array();
+		types::vector & elements = output.get_array();
+		elements.resize(array.elements.size());
+		for(std::size_t i = 0, end = elements.size(); i < end; i++)
+			evaluate(array.elements[i], elements[i]);
+	}
+}
@@ -0,0 +1,106 @@
+#include <fridh/interpreter.hpp>
+
+namespace fridh
+{
+	bool interpreter::get_condition(parse_tree_node const & conditional)
+	{
+		variable value;
+		evaluate(conditional, value);
+		return value.get_boolean_value();
+	}
+
+	bool interpreter::execute_units(executable_units const & units)
+	{
+		for(executable_units::const_iterator i = units.begin(), end = units.end(); i != end; i++)
+		{
+			if(execute_unit(*i))
+				return true;
+		}
+		return false;
+	}
+
+	bool interpreter::execute_for_each(for_each_statement const & statement)
+	{
+		variable container;
+		evaluate(statement.container, container);
+
+		types::vector const & elements = static_cast<variable const &>(container).get_array();
+		std::vector<variable const *> & iterators = current_frame->iterators;
+		iterators.push_back(0);
+
+		bool returned = false;
+		for(std::size_t i = 0; !returned && i < elements.size(); i++)
+		{
+			iterators.back() = &elements[i];
+			returned = execute_units(statement.body);
+		}
+
+		iterators.pop_back();
+		return returned;
+	}
+
+	bool interpreter::execute_unit(executable_unit const & unit)
+	{
+		statistics.instructions++;
+
+		switch(unit.type)
+		{
+			case executable_unit_type::statement:
+			{
+				variable result;
+				evaluate(*unit.statement_pointer, result);
+				return false;
+			}
+
+			case executable_unit_type::return_statement:
+				evaluate(*unit.statement_pointer, current_frame->return_value);
+				return true;
+
+			case executable_unit_type::if_statement:
+			{
+				if_statement const & statement = *unit.if_pointer;
+				if(get_condition(statement.conditional_term))
+					return execute_units(statement.body);
+				return false;
+			}
+
+			case executable_unit_type::if_else_statement:
+			{
+				if_else_statement const & statement = *unit.if_else_pointer;
+				if(get_condition(statement.conditional_term))
+					return execute_units(statement.if_body);
+				else
+					return execute_units(statement.else_body);
+			}
+
+			case executable_unit_type::for_each_statement:
+				return execute_for_each(*unit.for_each_pointer);
+
+			case executable_unit_type::for_statement:
+			{
+				for_statement const & statement = *unit.for_pointer;
+				variable result;
+				for(evaluate(statement.initialisation, result); get_condition(statement.conditional); evaluate(statement.iteration, result))
+				{
+					if(execute_units(statement.body))
+						return true;
+				}
+				return false;
+			}
+
+			case executable_unit_type::while_statement:
+			{
+				while_statement const & statement = *unit.while_pointer;
+				while(get_condition(statement.conditional_term))
+				{
+					if(execute_units(statement.body))
+						return true;
+				}
+				return false;
+			}
+
+			default:
+				throw ail::exception("Encountered an uninitialised executable unit");
+		}
+	}
+}
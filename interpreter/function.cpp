@@ -1,3 +1,31 @@
+#include <ail/string.hpp>
+#include <fridh/interpreter.hpp>
+
 namespace fridh
 {
+	void interpreter::call_function(function & target, std::vector<variable> & arguments, variable & output)
+	{
+		if(arguments.size() != target.arguments.size())
+			throw ail::exception("Invalid argument count in function call: expected " + ail::number_to_string(target.arguments.size()) + ", got " + ail::number_to_string(arguments.size()));
+
+		call_frame frame(target.local_count);
+		for(std::size_t i = 0, end = arguments.size(); i < end; i++)
+			frame.locals[i] = arguments[i];
+
+		call_frame * previous_frame = current_frame;
+		current_frame = &frame;
+
+		try
+		{
+			execute_units(target.body);
+		}
+		catch(...)
+		{
+			current_frame = previous_frame;
+			throw;
+		}
+
+		current_frame = previous_frame;
+		output = frame.return_value;
+	}
 }
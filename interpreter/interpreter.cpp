@@ -1,12 +1,75 @@
 #include <ail/file.hpp>
 #include <ail/string.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <fridh/interpreter.hpp>
 #include <fridh/lexer.hpp>
+#include <fridh/resolver.hpp>
 
 namespace fridh
 {
+	execution_statistics::execution_statistics():
+		instructions(0),
+		microseconds(0)
+	{
+	}
+
+	std::string execution_statistics::to_string() const
+	{
+		std::string output = ail::number_to_string(instructions) + " instruction(s) in " + ail::number_to_string(microseconds) + " us";
+		if(microseconds > 0)
+			output += " (" + ail::number_to_string(static_cast<uword>(static_cast<double>(instructions) / microseconds * 1000000.0)) + " instructions/s)";
+		return output;
+	}
+
+	interpreter::call_frame::call_frame(uword local_count):
+		locals(local_count)
+	{
+		return_value.nil();
+	}
+
 	interpreter::interpreter():
-		running(false)
+		running(false),
+		current_frame(0)
+	{
+	}
+
+	bool interpreter::run(module & target_module, variable & output, std::string & error_message)
+	{
+		if(running)
+		{
+			error_message = "The interpreter is already running";
+			return false;
+		}
+
+		running = true;
+		statistics = execution_statistics();
+		resolve_module(target_module);
+
+		boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+
+		bool success = true;
+		try
+		{
+			std::vector<variable> arguments;
+			call_function(target_module.entry_function, arguments, output);
+		}
+		catch(ail::exception & exception)
+		{
+			error_message = target_module.path + ": " + exception.get_message();
+			success = false;
+		}
+
+		boost::posix_time::ptime end = boost::posix_time::microsec_clock::universal_time();
+		statistics.microseconds = static_cast<uword>((end - start).total_microseconds());
+
+		current_frame = 0;
+		running = false;
+
+		return success;
+	}
+
+	execution_statistics const & interpreter::get_statistics() const
 	{
+		return statistics;
 	}
 }
@@ -4,6 +4,181 @@
 
 namespace fridh
 {
+	namespace
+	{
+		//tables up to this size are searched linearly
+		std::size_t const linear_search_limit = 8;
+
+		std::size_t const no_index = ~static_cast<std::size_t>(0);
+
+		//atoms are allocated sequentially, the multiplication spreads them across the slots
+		std::size_t hash_atom(atom name)
+		{
+			return static_cast<std::size_t>(name * static_cast<boost::uint32_t>(2654435761u));
+		}
+	}
+
+	node_children::iterator node_children::begin()
+	{
+		return entries.begin();
+	}
+
+	node_children::iterator node_children::end()
+	{
+		return entries.end();
+	}
+
+	node_children::const_iterator node_children::begin() const
+	{
+		return entries.begin();
+	}
+
+	node_children::const_iterator node_children::end() const
+	{
+		return entries.end();
+	}
+
+	std::size_t node_children::size() const
+	{
+		return entries.size();
+	}
+
+	bool node_children::empty() const
+	{
+		return entries.empty();
+	}
+
+	node_children::iterator node_children::find(atom name)
+	{
+		std::size_t index = find_index(name);
+		if(index == no_index)
+			return entries.end();
+		return entries.begin() + index;
+	}
+
+	node_children::const_iterator node_children::find(atom name) const
+	{
+		std::size_t index = find_index(name);
+		if(index == no_index)
+			return entries.end();
+		return entries.begin() + index;
+	}
+
+	symbol_tree_node * & node_children::operator[](atom name)
+	{
+		std::size_t index = find_index(name);
+		if(index != no_index)
+			return entries[index].second;
+
+		entries.push_back(value_type(name, 0));
+		if(entries.size() > linear_search_limit)
+		{
+			//the load factor is kept below one half
+			if(entries.size() * 2 > slots.size())
+				rebuild_slots();
+			else
+				add_slot(entries.size() - 1);
+		}
+		return entries.back().second;
+	}
+
+	void node_children::erase(iterator position)
+	{
+		std::size_t index = position - entries.begin();
+		if(!slots.empty())
+			remove_slot(index);
+		entries.erase(position);
+		if(entries.size() <= linear_search_limit)
+			slots.clear();
+	}
+
+	void node_children::clear()
+	{
+		entries.clear();
+		slots.clear();
+	}
+
+	void node_children::swap(node_children & other)
+	{
+		entries.swap(other.entries);
+		slots.swap(other.slots);
+	}
+
+	std::size_t node_children::find_index(atom name) const
+	{
+		if(slots.empty())
+		{
+			for(std::size_t i = 0, end = entries.size(); i < end; i++)
+			{
+				if(entries[i].first == name)
+					return i;
+			}
+			return no_index;
+		}
+
+		std::size_t mask = slots.size() - 1;
+		for(std::size_t slot = hash_atom(name) & mask; slots[slot] != 0; slot = (slot + 1) & mask)
+		{
+			std::size_t index = slots[slot] - 1;
+			if(entries[index].first == name)
+				return index;
+		}
+		return no_index;
+	}
+
+	void node_children::add_slot(std::size_t index)
+	{
+		std::size_t
+			mask = slots.size() - 1,
+			slot = hash_atom(entries[index].first) & mask;
+		while(slots[slot] != 0)
+			slot = (slot + 1) & mask;
+		slots[slot] = static_cast<boost::uint32_t>(index + 1);
+	}
+
+	//backward shift deletion, so no tombstones are left behind
+	void node_children::remove_slot(std::size_t index)
+	{
+		std::size_t
+			mask = slots.size() - 1,
+			slot = hash_atom(entries[index].first) & mask;
+		while(slots[slot] != index + 1)
+			slot = (slot + 1) & mask;
+
+		//the following slots of the cluster move into the gap unless it lies in front of their home slot
+		for(std::size_t next = (slot + 1) & mask; slots[next] != 0; next = (next + 1) & mask)
+		{
+			std::size_t home = hash_atom(entries[slots[next] - 1].first) & mask;
+			if(((next - home) & mask) >= ((next - slot) & mask))
+			{
+				slots[slot] = slots[next];
+				slot = next;
+			}
+		}
+		slots[slot] = 0;
+
+		//the entries following the removed one move down by one
+		for(std::vector<boost::uint32_t>::iterator i = slots.begin(), end = slots.end(); i != end; i++)
+		{
+			if(*i > index + 1)
+				(*i)--;
+		}
+	}
+
+	void node_children::rebuild_slots()
+	{
+		slots.clear();
+		if(entries.size() <= linear_search_limit)
+			return;
+
+		std::size_t slot_count = 4 * linear_search_limit;
+		while(slot_count < entries.size() * 4)
+			slot_count *= 2;
+		slots.resize(slot_count, 0);
+		for(std::size_t i = 0, end = entries.size(); i < end; i++)
+			add_slot(i);
+	}
+
 	symbol_tree_node::symbol_tree_node():
 		type(symbol::uninitialised),
 		parent(0)
@@ -101,7 +276,7 @@ namespace fridh
 
 	}
 
-	bool symbol_tree_node::exists(std::string const & name)
+	bool symbol_tree_node::exists(atom name)
 	{
 		//std::cout << "exists " << (void *)this << std::endl;
 
@@ -109,7 +284,7 @@ namespace fridh
 		return iterator != children.end();
 	}
 
-	bool symbol_tree_node::find_entity(std::string const & name, symbol_tree_node * & output)
+	bool symbol_tree_node::find_entity(atom name, symbol_tree_node * & output)
 	{
 		node_children::iterator iterator = children.find(name);
 		if(iterator == children.end())
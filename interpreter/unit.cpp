@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <fridh/symbol.hpp>
 
 namespace fridh
@@ -24,6 +25,36 @@ namespace fridh
 		return *this;
 	}
 
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+	executable_unit::executable_unit(executable_unit && other) BOOST_NOEXCEPT
+	{
+		move(other);
+	}
+
+	executable_unit & executable_unit::operator=(executable_unit && other) BOOST_NOEXCEPT
+	{
+		if(this != &other)
+		{
+			destroy();
+			move(other);
+		}
+		return *this;
+	}
+#endif
+
+	void executable_unit::move(executable_unit & other) BOOST_NOEXCEPT
+	{
+		type = other.type;
+		statement_pointer = other.statement_pointer;
+		other.type = executable_unit_type::uninitialised;
+	}
+
+	void executable_unit::swap(executable_unit & other) BOOST_NOEXCEPT
+	{
+		std::swap(type, other.type);
+		std::swap(statement_pointer, other.statement_pointer);
+	}
+
 	void executable_unit::copy(executable_unit const & other)
 	{
 #define COPY_MEMBER(type, member_type, member) \
@@ -2,50 +2,80 @@
 
 namespace fridh
 {
-	void lexer::parse_comment()
+	namespace
 	{
 		std::string const
 			multi_line_comment = ";;",
 			nested_comment_start = ";.",
-			nested_comment_end = ".;",
-
-			multiline_comment_prefix = "In multi-line comment: ",
-			nested_comment_prefix = "In nested comment: ";
+			nested_comment_end = ".;";
+	}
 
-		uword start_of_comment = line;
+	bool lexer::parse_comment()
+	{
+		comment_line = line;
 
 		if(string_match(multi_line_comment))
 		{
-			bool got_end = false;
-			for(i += multi_line_comment.size(); !got_end && i < end;)
+			i += multi_line_comment.size();
+			open_comment = comment_type::multi_line;
+		}
+		else if(string_match(nested_comment_start))
+		{
+			i += nested_comment_start.size();
+			open_comment = comment_type::nested;
+			comment_depth = 1;
+		}
+		else
+		{
+			std::size_t offset = kernels->find_delimiter(input, i, end, '\n', '\n', '\n');
+			if(offset == end)
 			{
-				char byte = input[i];
-				switch(byte)
-				{
-					case '\n':
-						process_newline();
-						continue;
+				if(more_input)
+					return false;
+				lexer_error("Unable to find the end of a multi-line comment", comment_line);
+			}
+			i = offset;
+			process_newline();
+			return true;
+		}
 
-					case ';':
-						if(string_match(multi_line_comment))
-						{
-							got_end = true;
-							i++;
-						}
-						break;
+		return parse_open_comment();
+	}
+
+	//in streaming mode a comment may remain open until the next chunk arrives, it is then continued where this one ended
+	bool lexer::parse_open_comment()
+	{
+		if(open_comment == comment_type::multi_line)
+		{
+			while(i < end)
+			{
+				i = kernels->find_delimiter(input, i, end, ';', '\n', '\n');
+				if(i == end)
+					break;
+
+				if(input[i] == '\n')
+				{
+					process_newline();
+					continue;
+				}
+				else if(string_match(multi_line_comment))
+				{
+					i += multi_line_comment.size();
+					open_comment = comment_type::none;
+					return true;
 				}
 				i++;
 			}
-			if(!got_end)
-				lexer_error("Unable to find the end of a multi-line comment", start_of_comment);
 		}
-		else if(string_match(nested_comment_start))
+		else
 		{
-			uword comment_depth = 1;
-			for(i += nested_comment_start.size(); comment_depth > 0 && i < end;)
+			while(i < end)
 			{
-				char byte = input[i];
-				if(byte == '\n')
+				i = kernels->find_delimiter(input, i, end, ';', '.', '\n');
+				if(i == end)
+					break;
+
+				if(input[i] == '\n')
 				{
 					process_newline();
 					continue;
@@ -60,21 +90,24 @@ namespace fridh
 				{
 					comment_depth--;
 					i += nested_comment_end.size();
+					if(comment_depth == 0)
+					{
+						open_comment = comment_type::none;
+						return true;
+					}
 					continue;
 				}
 				i++;
 			}
-
-			if(comment_depth != 0)
-				lexer_error("Unable to find the end of a nested comment", start_of_comment);
 		}
+
+		if(more_input)
+			return false;
+
+		if(open_comment == comment_type::multi_line)
+			lexer_error("Unable to find the end of a multi-line comment", comment_line);
 		else
-		{
-			std::size_t offset = input.find('\n', i);
-			if(offset == std::string::npos)
-				lexer_error("Unable to find the end of a multi-line comment", start_of_comment);
-			i = offset;
-			process_newline();
-		}
+			lexer_error("Unable to find the end of a nested comment", comment_line);
+		return false;
 	}
 }
@@ -1,10 +1,12 @@
+#include <algorithm>
 #include <fridh/lexer.hpp>
 #include <ail/string.hpp>
 
 namespace fridh
 {	
 	lexeme::lexeme():
-		type(lexeme_type::uninitialised)
+		type(lexeme_type::uninitialised),
+		view_length(owned_string)
 	{
 	}
 
@@ -14,40 +16,55 @@ namespace fridh
 	}
 
 	lexeme::lexeme(lexeme_type::type type):
-		type(type)
+		type(type),
+		view_length(owned_string)
 	{
 	}
 
 	lexeme::lexeme(types::boolean boolean):
 		type(lexeme_type::boolean),
+		view_length(owned_string),
 		boolean(boolean)
 	{
 	}
 
 	lexeme::lexeme(types::signed_integer signed_integer):
 		type(lexeme_type::signed_integer),
+		view_length(owned_string),
 		signed_integer(signed_integer)
 	{
 	}
 
 	lexeme::lexeme(types::unsigned_integer unsigned_integer):
 		type(lexeme_type::unsigned_integer),
+		view_length(owned_string),
 		unsigned_integer(unsigned_integer)
 	{
 	}
 
 	lexeme::lexeme(types::floating_point_value floating_point_value):
 		type(lexeme_type::floating_point_value),
+		view_length(owned_string),
 		floating_point_value(floating_point_value)
 	{
 	}
 
 	lexeme::lexeme(std::string const & string):
 		type(lexeme_type::string),
+		view_length(owned_string),
 		string(new std::string(string))
 	{
 	}
 
+	lexeme::lexeme(lexeme_type::type type, char const * view, std::size_t view_length):
+		type(type),
+		view_length(static_cast<boost::uint32_t>(view_length)),
+		view(view)
+	{
+		if(view_length >= owned_string)
+			throw ail::exception("Lexeme exceeds the maximal view length");
+	}
+
 	lexeme::~lexeme()
 	{
 		destroy();
@@ -58,7 +75,7 @@ namespace fridh
 		switch(type)
 		{
 			case lexeme_type::name:
-				return "name: " + *string;
+				return "name: " + get_string();
 
 			case lexeme_type::nil:
 				return "nil";
@@ -76,7 +93,7 @@ namespace fridh
 				return "float: " + ail::number_to_string(floating_point_value);
 
 			case lexeme_type::string:
-				return "string: " + ail::replace_string(*string, "\n", "\\n");
+				return "string: " + ail::replace_string(get_string(), "\n", "\\n");
 
 			case lexeme_type::addition:
 				return "+";
@@ -227,16 +244,52 @@ namespace fridh
 		return *this;
 	}
 
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+	lexeme::lexeme(lexeme && other) BOOST_NOEXCEPT
+	{
+		move(other);
+	}
+
+	lexeme & lexeme::operator=(lexeme && other) BOOST_NOEXCEPT
+	{
+		if(this != &other)
+		{
+			destroy();
+			move(other);
+		}
+		return *this;
+	}
+#endif
+
+	void lexeme::move(lexeme & other) BOOST_NOEXCEPT
+	{
+		type = other.type;
+		view_length = other.view_length;
+		unsigned_integer = other.unsigned_integer;
+		other.type = lexeme_type::uninitialised;
+	}
+
+	void lexeme::swap(lexeme & other) BOOST_NOEXCEPT
+	{
+		std::swap(type, other.type);
+		std::swap(view_length, other.view_length);
+		std::swap(unsigned_integer, other.unsigned_integer);
+	}
+
 	void lexeme::copy(lexeme const & other)
 	{
 		type = other.type;
-		if(is_string())
+		view_length = other.view_length;
+		//views merely reference the input so they can be copied like the numeric values
+		if(is_string() && !is_view())
 			string = new std::string(*other.string);
+		else
+			unsigned_integer = other.unsigned_integer;
 	}
 
 	void lexeme::destroy()
 	{
-		if(is_string())
+		if(is_string() && !is_view())
 			delete string;
 
 		type = lexeme_type::uninitialised;
@@ -244,9 +297,20 @@ namespace fridh
 
 	bool lexeme::is_string() const
 	{
-		return
-			type == lexeme_type::name ||
-			type == lexeme_type::string
-		;
+		return type == lexeme_type::string;
+	}
+
+	bool lexeme::is_view() const
+	{
+		return view_length != owned_string;
+	}
+
+	std::string lexeme::get_string() const
+	{
+		if(type == lexeme_type::name)
+			return get_atom_string(name);
+		if(is_view())
+			return std::string(view, view_length);
+		return *string;
 	}
 }
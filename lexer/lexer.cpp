@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cstring>
 #include <fridh/lexer.hpp>
 #include <ail/array.hpp>
 #include <ail/string.hpp>
@@ -5,13 +7,27 @@
 
 namespace fridh
 {
-	boost::mutex table_mutex;
+	namespace
+	{
+		bool keyword_match(char const * data, std::size_t length, char const * keyword)
+		{
+			return length == std::strlen(keyword) && std::memcmp(data, keyword, length) == 0;
+		}
+	}
 
 	line_of_code::line_of_code():
+		line(0),
 		indentation_level(0)
 	{
 	}
 
+	void line_of_code::swap(line_of_code & other)
+	{
+		std::swap(line, other.line);
+		std::swap(indentation_level, other.indentation_level);
+		lexemes.swap(other.lexemes);
+	}
+
 	operator_lexeme::operator_lexeme(lexeme_type::type lexeme, std::string const & string):
 		lexeme(lexeme),
 		string(string)
@@ -23,32 +39,72 @@ namespace fridh
 		return string.length() > other.string.length();
 	}
 
-	lexer::lexer(std::string const & input, lines_of_code & lines):
+	lexer::lexer(std::string const & input, lines_of_code & lines, bool use_views):
+		input(input.data()),
+		input_size(input.size()),
+		lines(lines),
+		use_views(use_views),
+		consumer(0),
+		more_input(false),
+		first_line(1)
+	{
+	}
+
+	lexer::lexer(char const * input, std::size_t input_size, lines_of_code & lines, bool use_views):
+		input(input),
+		input_size(input_size),
+		lines(lines),
+		use_views(use_views),
+		consumer(0),
+		more_input(false),
+		first_line(1)
+	{
+	}
+
+	lexer::lexer(char const * input, std::size_t input_size, line_consumer & consumer, bool use_views):
 		input(input),
-		lines(lines)
+		input_size(input_size),
+		lines(buffered_lines),
+		use_views(use_views),
+		consumer(&consumer),
+		more_input(false),
+		first_line(1)
+	{
+	}
+
+	void lexer::set_first_line(uword new_first_line)
 	{
+		first_line = new_first_line;
+		line = new_first_line;
 	}
 
 	bool lexer::parse_operator(line_of_code & output)
 	{
-		std::size_t remaining_characters = end - i;
+		operator_state const * states = &operator_states[0];
 
-		BOOST_FOREACH(operator_lexeme & current_lexeme, operator_lexeme_data)
+		//the longest operator wins, e.g. "**=" over "**"
+		std::size_t state = 0;
+		std::size_t match_length = 0;
+		lexeme_type::type match;
+		for(std::size_t offset = i; offset < end; offset++)
 		{
-			std::size_t operator_length = current_lexeme.string.size();
-			if(remaining_characters < operator_length)
-				return false;
-
-			std::string substring = input.substr(i, operator_length);
+			state = states[state].transitions[static_cast<uchar>(input[offset])];
+			if(state == 0)
+				break;
 
-			if(substring == current_lexeme.string)
+			if(states[state].accepting)
 			{
-				output.lexemes.push_back(current_lexeme.lexeme);
-				i += operator_length;
-				return true;
+				match = states[state].lexeme;
+				match_length = offset + 1 - i;
 			}
 		}
-		return false;
+
+		if(match_length == 0)
+			return false;
+
+		output.lexemes.push_back(lexeme(match));
+		i += match_length;
+		return true;
 	}
 
 	void lexer::lexer_error(std::string const & message, uword error_line)
@@ -63,31 +119,27 @@ namespace fridh
 		lexer_error(message);
 	}
 	
-	bool lexer::is_name_char(char input)
-	{
-		return ail::is_alpha(input) || ail::is_digit(input) || input == '_';
-	}
-
 	void lexer::parse_name(line_of_code & output)
 	{
 		std::size_t start = i;
-		for(i++; i < end && is_name_char(input[i]); i++);
-		std::string name = input.substr(start, i - start);
+		i = kernels->skip_name_characters(input, i + 1, end);
+		char const * name = input + start;
+		std::size_t length = i - start;
 
 		lexeme current_lexeme;
-		if(name == "true")
+		if(keyword_match(name, length, "true"))
 			current_lexeme = lexeme(true);
-		else if(name == "false")
+		else if(keyword_match(name, length, "false"))
 			current_lexeme = lexeme(false);
-		else if(name == "nil")
+		else if(keyword_match(name, length, "nil"))
 			current_lexeme.type = lexeme_type::nil;
 		else
 		{
-			current_lexeme = lexeme(name);
 			current_lexeme.type = lexeme_type::name;
+			current_lexeme.name = get_atom(name, length);
 		}
 
-		output.lexemes.push_back(current_lexeme);
+		move_back(output.lexemes, current_lexeme);
 	}
 
 	bool lexer::string_match(std::string const & target)
@@ -95,17 +147,34 @@ namespace fridh
 		if(end - i < target.size())
 			return false;
 
-		return input.substr(i, target.size()) == target;
+		return std::memcmp(input + i, target.data(), target.size()) == 0;
 	}
 
-	void lexer::process_newline(bool next_line)
+	void lexer::add_current_line()
 	{
-		if(!current_line.lexemes.empty())
+		if(current_line.lexemes.empty())
+			return;
+
+		if(consumer != 0 && !more_input)
 		{
+			//without further chunks no line has to be lexed again so it can be handed over right away
 			current_line.line = line;
-			lines.push_back(current_line);
+			consumer->consume(current_line);
+			current_line.lexemes.clear();
+			return;
 		}
-		std::string line_string = input.substr(line_offset, i - line_offset);
+
+		//the lexemes are handed over instead of copying the line
+		lines.push_back(line_of_code());
+		line_of_code & new_line = lines.back();
+		new_line.line = line;
+		new_line.indentation_level = current_line.indentation_level;
+		new_line.lexemes.swap(current_line.lexemes);
+	}
+
+	void lexer::process_newline(bool next_line)
+	{
+		add_current_line();
 		current_line = line_of_code();
 
 		i++;
@@ -116,7 +185,7 @@ namespace fridh
 		else
 		{
 			//skip initial spaces after ` and (
-			for(; i < end && input[i] == ' '; i++);
+			i = kernels->skip_spaces(input, i, end);
 		}
 	}
 
@@ -127,15 +196,35 @@ namespace fridh
 		current_line.indentation_level = indentation_level + summand;
 	}
 
-	void lexer::parse_lexemes()
+	void lexer::initialise()
 	{
 		initialise_tables();
 
-		line = 1;
+		kernels = &get_scan_kernels();
+
+		line = first_line;
 
 		line_offset = 0;
 
-		for(i = 0, end = input.size(); i < end;)
+		i = 0;
+
+		open_comment = comment_type::none;
+	}
+
+	void lexer::parse_lexemes()
+	{
+		initialise();
+		end = input_size;
+		parse_range();
+		add_current_line();
+	}
+
+	bool lexer::parse_range()
+	{
+		if(open_comment != comment_type::none && !parse_open_comment())
+			return false;
+
+		while(i < end)
 		{
 			if(parse_operator(current_line))
 				continue;
@@ -154,7 +243,7 @@ namespace fridh
 
 				case ' ':
 				case '\r':
-					i++;
+					i = kernels->skip_spaces(input, i, end);
 					continue;
 
 				case '\n':
@@ -165,14 +254,13 @@ namespace fridh
 
 				case '\'':
 				case '"':
-				{
-					std::string string;
 					parse_string(current_line);
 					continue;
-				}
 
 				case ';':
-					parse_comment();
+					//comments are the only constructs which span lines so they are the only ones which may have to wait for the next chunk
+					if(!parse_comment())
+						return false;
 					continue;
 
 				case '`':
@@ -194,11 +282,7 @@ namespace fridh
 			parse_name(current_line);
 		}
 
-		if(!current_line.lexemes.empty())
-		{
-			current_line.line = line;
-			lines.push_back(current_line);
-		}
+		return true;
 	}
 
 	std::string visualise_lexemes(lines_of_code & lines)
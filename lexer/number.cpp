@@ -14,9 +14,10 @@ namespace fridh
 			if(byte == '0')
 			{
 				std::size_t remaining_bytes = end - i;
-				if(remaining_bytes > 1)
+				if(remaining_bytes > 0)
 				{
-					char next_byte = input[i + 1];
+					//i already points to the byte after the 0
+					char next_byte = input[i];
 					if(next_byte == 'x')
 					{
 						i++;
@@ -32,7 +33,7 @@ namespace fridh
 						if(hex_length == 0)
 							lexer_error("Incomplete hex number");
 
-						std::string hex_string = input.substr(hex_start, i - end);
+						std::string hex_string(input + hex_start, hex_length);
 						types::unsigned_integer value = ail::string_to_number<types::unsigned_integer>(hex_string, std::ios_base::hex);
 						output.lexemes.push_back(lexeme(value));
 						return true;
@@ -63,7 +64,7 @@ namespace fridh
 			if(last_byte == dot)
 				number_parsing_error("Encountered a floating point value ending with a dot");
 
-			std::string number_string = input.substr(start, i - start);
+			std::string number_string(input + start, i - start);
 			lexeme current_lexeme;
 			if(got_dot)
 				current_lexeme = lexeme(ail::string_to_number<types::floating_point_value>(number_string));
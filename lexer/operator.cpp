@@ -2,11 +2,10 @@
 #include <algorithm>
 #include <ail/string.hpp>
 #include <ail/array.hpp>
+#include <boost/thread/once.hpp>
 
 namespace fridh
 {
-	bool tables_initialised = false;
-
 	operator_lexeme operators[] =
 	{
 		operator_lexeme(lexeme_type::addition, "+"),
@@ -75,19 +74,60 @@ namespace fridh
 	};
 
 	std::vector<operator_lexeme> operator_lexeme_data;
+	std::vector<operator_state> operator_states;
 
-	void initialise_tables()
+	operator_state::operator_state():
+		accepting(false),
+		lexeme(lexeme_type::uninitialised)
 	{
-		boost::mutex::scoped_lock scoped_lock(table_mutex);
-
-		if(tables_initialised)
-			return;
-
-		tables_initialised = true;
+		std::fill(transitions, transitions + ail::countof(transitions), 0);
+	}
 
-		std::sort(operators, operators + ail::countof(operators));
+	namespace
+	{
+		boost::once_flag tables_flag = BOOST_ONCE_INIT;
+
+		void add_operator_state(operator_lexeme const & current_lexeme)
+		{
+			std::size_t state = 0;
+			for(std::size_t i = 0; i < current_lexeme.string.size(); i++)
+			{
+				uchar byte = static_cast<uchar>(current_lexeme.string[i]);
+				std::size_t next_state = operator_states[state].transitions[byte];
+				if(next_state == 0)
+				{
+					next_state = operator_states.size();
+					if(next_state > 0xff)
+						throw ail::exception("Too many operator states");
+					operator_states.push_back(operator_state());
+					operator_states[state].transitions[byte] = static_cast<boost::uint8_t>(next_state);
+				}
+				state = next_state;
+			}
+
+			operator_state & final_state = operator_states[state];
+			final_state.accepting = true;
+			final_state.lexeme = current_lexeme.lexeme;
+		}
+
+		void build_tables()
+		{
+			std::sort(operators, operators + ail::countof(operators));
+
+			for(std::size_t i = 0; i < ail::countof(operators); i++)
+				operator_lexeme_data.push_back(operators[i]);
+
+			operator_states.push_back(operator_state());
+			for(std::size_t i = 0; i < ail::countof(operators); i++)
+				add_operator_state(operators[i]);
+
+			select_scan_method(get_best_scan_method());
+		}
+	}
 
-		for(std::size_t i = 0; i < ail::countof(operators); i++)
-			operator_lexeme_data.push_back(operators[i]);
+	void initialise_tables()
+	{
+		//once the tables have been built this merely checks a flag, lexers running in parallel don't serialise on a lock
+		boost::call_once(tables_flag, &build_tables);
 	}
 }
@@ -0,0 +1,119 @@
+#include <fridh/pipeline.hpp>
+
+namespace fridh
+{
+	lexer_pipeline::lexer_pipeline(char const * input, std::size_t input_size):
+		input(input),
+		input_size(input_size),
+		batch(0),
+		done(false),
+		success(false),
+		thread(&lexer_pipeline::run, this)
+	{
+	}
+
+	lexer_pipeline::~lexer_pipeline()
+	{
+		std::string error;
+		finish(error);
+	}
+
+	bool lexer_pipeline::pull(lines_of_code & output)
+	{
+		for(unsigned spin = 0; ; spin++)
+		{
+			//the flag must be read before trying the ring, a batch pushed right before the lexer finished would be lost otherwise
+			bool lexer_done = done.load(boost::memory_order_acquire);
+
+			lines_of_code * next_batch;
+			if(ring.pop(next_batch))
+			{
+				//the lexer may be waiting for room in the ring
+				notify();
+				for(lines_of_code::iterator i = next_batch->begin(), end = next_batch->end(); i != end; i++)
+					move_back(output, *i);
+				delete next_batch;
+				return true;
+			}
+
+			if(lexer_done)
+				return false;
+
+			if(spin < spin_limit)
+			{
+				boost::this_thread::yield();
+				continue;
+			}
+
+			//the lexer takes the mutex after pushing a batch so it can't slip in between the check and the wait
+			boost::mutex::scoped_lock scoped_lock(mutex);
+			while(ring.read_available() == 0 && !done.load(boost::memory_order_acquire))
+				ring_changed.wait(scoped_lock);
+		}
+	}
+
+	bool lexer_pipeline::finish(std::string & error_output)
+	{
+		if(thread.joinable())
+		{
+			//the lexer may be blocked on a full ring
+			lines_of_code discarded;
+			while(pull(discarded))
+				discarded.clear();
+			thread.join();
+		}
+
+		if(!success)
+			error_output = error;
+		return success;
+	}
+
+	void lexer_pipeline::consume(line_of_code & line)
+	{
+		if(batch == 0)
+		{
+			batch = new lines_of_code;
+			batch->reserve(batch_size);
+		}
+
+		move_back(*batch, line);
+
+		if(batch->size() == batch_size)
+			push_batch();
+	}
+
+	void lexer_pipeline::run()
+	{
+		lexer current_lexer(input, input_size, *this, true);
+		success = current_lexer.parse(error);
+		if(batch != 0)
+			push_batch();
+		done.store(true, boost::memory_order_release);
+		notify();
+	}
+
+	void lexer_pipeline::push_batch()
+	{
+		for(unsigned spin = 0; !ring.push(batch); spin++)
+		{
+			if(spin < spin_limit)
+			{
+				boost::this_thread::yield();
+				continue;
+			}
+
+			boost::mutex::scoped_lock scoped_lock(mutex);
+			while(ring.write_available() == 0)
+				ring_changed.wait(scoped_lock);
+		}
+		batch = 0;
+		notify();
+	}
+
+	//only taken once per batch, which is cheap compared to lexing or parsing the lines of a batch
+	void lexer_pipeline::notify()
+	{
+		boost::mutex::scoped_lock scoped_lock(mutex);
+		ring_changed.notify_all();
+	}
+}
@@ -0,0 +1,268 @@
+#include <ail/exception.hpp>
+#include <fridh/scan.hpp>
+#include <fridh/lexer.hpp>
+
+#ifdef FRIDH_HAS_SIMD_SCAN
+#include <immintrin.h>
+#endif
+
+namespace fridh
+{
+	namespace
+	{
+		bool is_name_character(char input)
+		{
+			return
+				(input >= 'a' && input <= 'z') ||
+				(input >= 'A' && input <= 'Z') ||
+				(input >= '0' && input <= '9') ||
+				input == '_';
+		}
+
+		std::size_t scalar_skip_name_characters(char const * data, std::size_t offset, std::size_t end)
+		{
+			for(; offset < end && is_name_character(data[offset]); offset++);
+			return offset;
+		}
+
+		std::size_t scalar_skip_spaces(char const * data, std::size_t offset, std::size_t end)
+		{
+			for(; offset < end && (data[offset] == ' ' || data[offset] == '\r'); offset++);
+			return offset;
+		}
+
+		std::size_t scalar_find_delimiter(char const * data, std::size_t offset, std::size_t end, char first, char second, char third)
+		{
+			for(; offset < end; offset++)
+			{
+				char byte = data[offset];
+				if(byte == first || byte == second || byte == third)
+					break;
+			}
+			return offset;
+		}
+
+		scan_kernels const scalar_kernels =
+		{
+			&scalar_skip_name_characters,
+			&scalar_skip_spaces,
+			&scalar_find_delimiter
+		};
+
+#ifdef FRIDH_HAS_SIMD_SCAN
+
+		/*
+		The vector kernels process 16 (SSE2) or 32 (AVX2) bytes per iteration.
+		Each one builds a bit mask of the bytes which continue the run and stops at the first cleared bit.
+		The tail which doesn't fill an entire vector is handled by the scalar kernels.
+		*/
+
+		__attribute__((target("sse2")))
+		std::size_t sse2_skip_name_characters(char const * data, std::size_t offset, std::size_t end)
+		{
+			for(; offset + 16 <= end; offset += 16)
+			{
+				__m128i bytes = _mm_loadu_si128(reinterpret_cast<__m128i const *>(data + offset));
+				__m128i lower_case = _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8('a' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), bytes));
+				__m128i upper_case = _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8('A' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), bytes));
+				__m128i digits = _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8('0' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), bytes));
+				__m128i underscores = _mm_cmpeq_epi8(bytes, _mm_set1_epi8('_'));
+				__m128i name_characters = _mm_or_si128(_mm_or_si128(lower_case, upper_case), _mm_or_si128(digits, underscores));
+				unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(name_characters)) & 0xffff;
+				if(mask != 0)
+					return offset + __builtin_ctz(mask);
+			}
+			return scalar_skip_name_characters(data, offset, end);
+		}
+
+		__attribute__((target("sse2")))
+		std::size_t sse2_skip_spaces(char const * data, std::size_t offset, std::size_t end)
+		{
+			for(; offset + 16 <= end; offset += 16)
+			{
+				__m128i bytes = _mm_loadu_si128(reinterpret_cast<__m128i const *>(data + offset));
+				__m128i spaces = _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\r')));
+				unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(spaces)) & 0xffff;
+				if(mask != 0)
+					return offset + __builtin_ctz(mask);
+			}
+			return scalar_skip_spaces(data, offset, end);
+		}
+
+		__attribute__((target("sse2")))
+		std::size_t sse2_find_delimiter(char const * data, std::size_t offset, std::size_t end, char first, char second, char third)
+		{
+			__m128i
+				first_vector = _mm_set1_epi8(first),
+				second_vector = _mm_set1_epi8(second),
+				third_vector = _mm_set1_epi8(third);
+			for(; offset + 16 <= end; offset += 16)
+			{
+				__m128i bytes = _mm_loadu_si128(reinterpret_cast<__m128i const *>(data + offset));
+				__m128i delimiters = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, first_vector), _mm_cmpeq_epi8(bytes, second_vector)), _mm_cmpeq_epi8(bytes, third_vector));
+				unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(delimiters));
+				if(mask != 0)
+					return offset + __builtin_ctz(mask);
+			}
+			return scalar_find_delimiter(data, offset, end, first, second, third);
+		}
+
+		__attribute__((target("avx2")))
+		std::size_t avx2_skip_name_characters(char const * data, std::size_t offset, std::size_t end)
+		{
+			for(; offset + 32 <= end; offset += 32)
+			{
+				__m256i bytes = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(data + offset));
+				__m256i lower_case = _mm256_and_si256(_mm256_cmpgt_epi8(bytes, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), bytes));
+				__m256i upper_case = _mm256_and_si256(_mm256_cmpgt_epi8(bytes, _mm256_set1_epi8('A' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), bytes));
+				__m256i digits = _mm256_and_si256(_mm256_cmpgt_epi8(bytes, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), bytes));
+				__m256i underscores = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('_'));
+				__m256i name_characters = _mm256_or_si256(_mm256_or_si256(lower_case, upper_case), _mm256_or_si256(digits, underscores));
+				unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(name_characters));
+				if(mask != 0)
+					return offset + __builtin_ctz(mask);
+			}
+			return sse2_skip_name_characters(data, offset, end);
+		}
+
+		__attribute__((target("avx2")))
+		std::size_t avx2_skip_spaces(char const * data, std::size_t offset, std::size_t end)
+		{
+			for(; offset + 32 <= end; offset += 32)
+			{
+				__m256i bytes = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(data + offset));
+				__m256i spaces = _mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\r')));
+				unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(spaces));
+				if(mask != 0)
+					return offset + __builtin_ctz(mask);
+			}
+			return sse2_skip_spaces(data, offset, end);
+		}
+
+		__attribute__((target("avx2")))
+		std::size_t avx2_find_delimiter(char const * data, std::size_t offset, std::size_t end, char first, char second, char third)
+		{
+			__m256i
+				first_vector = _mm256_set1_epi8(first),
+				second_vector = _mm256_set1_epi8(second),
+				third_vector = _mm256_set1_epi8(third);
+			for(; offset + 32 <= end; offset += 32)
+			{
+				__m256i bytes = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(data + offset));
+				__m256i delimiters = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(bytes, first_vector), _mm256_cmpeq_epi8(bytes, second_vector)), _mm256_cmpeq_epi8(bytes, third_vector));
+				unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(delimiters));
+				if(mask != 0)
+					return offset + __builtin_ctz(mask);
+			}
+			return sse2_find_delimiter(data, offset, end, first, second, third);
+		}
+
+		scan_kernels const sse2_kernels =
+		{
+			&sse2_skip_name_characters,
+			&sse2_skip_spaces,
+			&sse2_find_delimiter
+		};
+
+		scan_kernels const avx2_kernels =
+		{
+			&avx2_skip_name_characters,
+			&avx2_skip_spaces,
+			&avx2_find_delimiter
+		};
+
+#endif
+
+		scan_method::type current_scan_method = scan_method::scalar;
+		scan_kernels const * current_scan_kernels = &scalar_kernels;
+	}
+
+	bool scan_method_is_supported(scan_method::type method)
+	{
+		switch(method)
+		{
+			case scan_method::scalar:
+				return true;
+
+#ifdef FRIDH_HAS_SIMD_SCAN
+			case scan_method::sse2:
+				return __builtin_cpu_supports("sse2");
+
+			case scan_method::avx2:
+				return __builtin_cpu_supports("avx2");
+#endif
+		}
+
+		return false;
+	}
+
+	scan_method::type get_best_scan_method()
+	{
+		if(scan_method_is_supported(scan_method::avx2))
+			return scan_method::avx2;
+		else if(scan_method_is_supported(scan_method::sse2))
+			return scan_method::sse2;
+		else
+			return scan_method::scalar;
+	}
+
+	void set_scan_method(scan_method::type method)
+	{
+		if(!scan_method_is_supported(method))
+			throw ail::exception("The " + get_scan_method_string(method) + " scan method is not supported by this CPU");
+
+		//otherwise the tables would replace the method with the default one once they get built
+		initialise_tables();
+		select_scan_method(method);
+	}
+
+	void select_scan_method(scan_method::type method)
+	{
+		switch(method)
+		{
+			case scan_method::scalar:
+				current_scan_kernels = &scalar_kernels;
+				break;
+
+#ifdef FRIDH_HAS_SIMD_SCAN
+			case scan_method::sse2:
+				current_scan_kernels = &sse2_kernels;
+				break;
+
+			case scan_method::avx2:
+				current_scan_kernels = &avx2_kernels;
+				break;
+#endif
+		}
+
+		current_scan_method = method;
+	}
+
+	scan_method::type get_scan_method()
+	{
+		initialise_tables();
+		return current_scan_method;
+	}
+
+	scan_kernels const & get_scan_kernels()
+	{
+		return *current_scan_kernels;
+	}
+
+	std::string get_scan_method_string(scan_method::type method)
+	{
+		switch(method)
+		{
+			case scan_method::scalar:
+				return "scalar";
+
+			case scan_method::sse2:
+				return "SSE2";
+
+			case scan_method::avx2:
+				return "AVX2";
+		}
+
+		return "unknown";
+	}
+}
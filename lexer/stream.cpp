@@ -0,0 +1,101 @@
+#include <istream>
+#include <vector>
+#include <fridh/lexer.hpp>
+#include <ail/exception.hpp>
+#include <boost/foreach.hpp>
+
+namespace fridh
+{
+	line_consumer::~line_consumer()
+	{
+	}
+
+	lexer::lexer(line_consumer & consumer):
+		input(0),
+		input_size(0),
+		lines(buffered_lines),
+		use_views(false),
+		consumer(&consumer),
+		more_input(true),
+		first_line(1)
+	{
+		initialise();
+	}
+
+	bool lexer::feed(char const * data, std::size_t size, std::string & error)
+	{
+		try
+		{
+			buffer.append(data, size);
+			process_chunks();
+			return true;
+		}
+		catch(ail::exception & exception)
+		{
+			error = exception.get_message();
+			return false;
+		}
+	}
+
+	bool lexer::feed(std::istream & stream, std::string & error, std::size_t chunk_size)
+	{
+		std::vector<char> chunk(chunk_size);
+		while(stream)
+		{
+			stream.read(&chunk[0], chunk_size);
+			std::size_t size = static_cast<std::size_t>(stream.gcount());
+			if(size == 0)
+				break;
+			if(!feed(&chunk[0], size, error))
+				return false;
+		}
+		return true;
+	}
+
+	bool lexer::finish(std::string & error)
+	{
+		try
+		{
+			more_input = false;
+			input = buffer.data();
+			input_size = buffer.size();
+			end = input_size;
+			parse_range();
+			add_current_line();
+			flush_lines();
+			buffer.clear();
+			return true;
+		}
+		catch(ail::exception & exception)
+		{
+			error = exception.get_message();
+			return false;
+		}
+	}
+
+	void lexer::process_chunks()
+	{
+		//only complete lines are lexed, the rest of the buffer waits for the next chunk
+		std::size_t offset = buffer.rfind('\n');
+		if(offset == std::string::npos || offset < i)
+			return;
+
+		input = buffer.data();
+		input_size = buffer.size();
+		end = offset + 1;
+		parse_range();
+		flush_lines();
+
+		//everything before the current line has been lexed and can be discarded
+		buffer.erase(0, line_offset);
+		i -= line_offset;
+		line_offset = 0;
+	}
+
+	void lexer::flush_lines()
+	{
+		BOOST_FOREACH(line_of_code & current_line, lines)
+			consumer->consume(current_line);
+		lines.clear();
+	}
+}
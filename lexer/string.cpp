@@ -5,12 +5,31 @@ namespace fridh
 {
 	void lexer::parse_string(line_of_code & output)
 	{
-		std::string string;
 		char string_character = input[i];
 		i++;
-		std::size_t start = i;
+
+		if(use_views)
+		{
+			//strings without escape sequences can reference the input directly
+			std::size_t offset = kernels->find_delimiter(input, i, end, string_character, '\\', '\n');
+			if(offset < end && input[offset] == string_character)
+			{
+				output.lexemes.push_back(lexeme(lexeme_type::string, input + i, offset - i));
+				i = offset + 1;
+				return;
+			}
+		}
+
+		std::string string;
 		for(; i < end; i++)
 		{
+			//plain runs between escape sequences are appended at once
+			std::size_t offset = kernels->find_delimiter(input, i, end, string_character, '\\', '\n');
+			string.append(input + i, offset - i);
+			i = offset;
+			if(i == end)
+				break;
+
 			char byte = input[i];
 			switch(byte)
 			{
@@ -42,7 +61,7 @@ namespace fridh
 						if(!ail::is_hex_digit(input[i + 1]))
 							lexer_error("Invalid hex number escape sequence");
 
-						std::string hex_string = input.substr(i, 2);
+						std::string hex_string(input + i, 2);
 						i++;
 						char new_byte = ail::string_to_number<char>(hex_string, std::ios_base::hex);
 						string.push_back(new_byte);
@@ -56,20 +75,11 @@ namespace fridh
 					lexer_error("Detected a newline in a string");
 					break;
 
-				case '\'':
-				case '"':
-					if(byte == string_character)
-					{
-						output.lexemes.push_back(lexeme(string));
-						i++;
-						return;
-					}
-					string.push_back(byte);
-					break;
-
 				default:
-					string.push_back(byte);
-					break;
+					//the only delimiter left is the terminator
+					output.lexemes.push_back(lexeme(string));
+					i++;
+					return;
 			}
 		}
 		lexer_error("String lacks terminator");
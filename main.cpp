@@ -1,24 +1,32 @@
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <string>
 #include <vector>
 
 #include <fridh/lexer.hpp>
+#include <fridh/source.hpp>
 #include <fridh/parser.hpp>
+#include <fridh/loader.hpp>
+#include <fridh/flat.hpp>
+#include <fridh/optimiser.hpp>
 #include <fridh/interpreter.hpp>
+#include <fridh/bytecode.hpp>
 
 #include <ail/file.hpp>
+#include <ail/string.hpp>
 
 bool perform_lexer_test(std::string const & input, std::string const & output)
 {
-	std::string code;
-	if(!ail::read_file(input, code))
+	fridh::source_buffer source;
+	if(!source.load(input))
 	{
 		std::cout << "Unable to read input" << std::endl;
 		return false;
 	}
 
 	fridh::lines_of_code lines;
-	fridh::lexer lexer(code, lines);
+	fridh::lexer lexer(source.data(), source.size(), lines, true);
 
 	std::string error;
 	if(!lexer.parse(error))
@@ -37,15 +45,70 @@ bool perform_lexer_test(std::string const & input, std::string const & output)
 	return true;
 }
 
-bool perform_parser_test(std::string const & input, std::string const & output)
+class line_collector: public fridh::line_consumer
+{
+public:
+	fridh::lines_of_code lines;
+
+	void consume(fridh::line_of_code & line)
+	{
+		fridh::move_back(lines, line);
+	}
+};
+
+bool perform_stream_lexer_test(std::string const & input, std::string const & output)
 {
-	std::string code;
-	if(!ail::read_file(input, code))
+	std::ifstream stream(input.c_str(), std::ios::binary);
+	if(!stream)
 	{
 		std::cout << "Unable to read input" << std::endl;
 		return false;
 	}
 
+	line_collector collector;
+	fridh::lexer lexer(collector);
+
+	std::string error;
+	if(!lexer.feed(stream, error) || !lexer.finish(error))
+	{
+		std::cout << "Error: " << error << std::endl;
+		return false;
+	}
+
+	std::cout << "Processed " << collector.lines.size() << " line(s) of code" << std::endl;
+
+	std::string data = fridh::visualise_lexemes(collector.lines);
+
+	std::cout << "Output: " << data.size() << " byte(s)" << std::endl;
+
+	ail::write_file(output, data);
+	return true;
+}
+
+bool perform_parser_test(std::string const & input, std::string const & output)
+{
+	fridh::module module;
+	fridh::parser parser;
+
+	std::string error;
+	if(!parser.process_module(input, "test", module, error))
+	{
+		std::cout << "Error: " << error << std::endl;
+		return false;
+	}
+
+	std::string data =
+		"Parsed " + ail::number_to_string(module.entry_function.body.size()) + " top-level unit(s)\n"
+		"Symbols: " + ail::number_to_string(module.symbols.children.size()) + "\n"
+		"Arena: " + ail::number_to_string(module.arena.get_allocation_count()) + " node(s), " + ail::number_to_string(module.arena.get_size()) + " byte(s)\n";
+	std::cout << data;
+
+	ail::write_file(output, data);
+	return true;
+}
+
+bool perform_flat_test(std::string const & input, std::string const & output)
+{
 	fridh::module module;
 	fridh::parser parser;
 
@@ -56,15 +119,148 @@ bool perform_parser_test(std::string const & input, std::string const & output)
 		return false;
 	}
 
+	fridh::flat_module flat;
+	fridh::flatten_module(module, flat);
+
+	std::cout << "Flattened " << flat.units.size() << " unit(s), " << flat.nodes.size() << " node(s) and " << flat.strings.size() << " string(s)" << std::endl;
+
+	//the statements of the entry function in the format of parse_tree_node::to_string, for diffing
+	std::string data;
+	fridh::flat_function const & entry_function = flat.functions[0];
+	for(fridh::flat_index i = entry_function.body.offset, end = entry_function.body.offset + entry_function.body.size; i < end; i++)
+	{
+		fridh::flat_unit const & unit = flat.units[i];
+		if(unit.type == fridh::executable_unit_type::statement || unit.type == fridh::executable_unit_type::return_statement)
+			data += flat.to_string(unit.index) + "\n";
+	}
+
+	ail::write_file(output, data);
 	return true;
 }
 
+bool perform_interpreter_test(std::string const & input, std::string const & output)
+{
+	fridh::module module;
+	fridh::parser parser;
+
+	std::string error;
+	if(!parser.process_module(input, "test", module, error))
+	{
+		std::cout << "Error: " << error << std::endl;
+		return false;
+	}
+
+	fridh::optimise_module(module);
+
+	fridh::interpreter interpreter;
+	fridh::variable result;
+	if(!interpreter.run(module, result, error))
+	{
+		std::cout << "Error: " << error << std::endl;
+		return false;
+	}
+
+	std::string data = result.get_string_representation();
+	std::cout << "Result: " << data << std::endl;
+	std::cout << "Executed " << interpreter.get_statistics().to_string() << std::endl;
+
+	ail::write_file(output, data);
+	return true;
+}
+
+bool perform_bytecode_test(std::string const & input, std::string const & output)
+{
+	fridh::module module;
+	fridh::parser parser;
+
+	std::string error;
+	if(!parser.process_module(input, "test", module, error))
+	{
+		std::cout << "Error: " << error << std::endl;
+		return false;
+	}
+
+	fridh::optimise_module(module);
+
+	fridh::bytecode_program program;
+	fridh::bytecode_compiler compiler;
+	if(!compiler.compile(module, program, error))
+	{
+		std::cout << "Error: " << error << std::endl;
+		return false;
+	}
+
+	std::string data = fridh::disassemble(program);
+	std::cout << "Bytecode: " << data.size() << " byte(s)" << std::endl;
+	ail::write_file(output, data);
+
+	fridh::virtual_machine machine;
+	fridh::variable result;
+	if(!machine.run(program, result, error))
+	{
+		std::cout << "Error: " << error << std::endl;
+		return false;
+	}
+
+	std::cout << "Result: " << result.get_string_representation() << std::endl;
+	std::cout << "Executed " << machine.get_statistics().to_string() << std::endl;
+	return true;
+}
+
+bool perform_loader_test(std::string const & input, std::string const & output)
+{
+	std::string list;
+	if(!ail::read_file(input, list))
+	{
+		std::cout << "Unable to read input" << std::endl;
+		return false;
+	}
+
+	//one path per line
+	std::vector<std::string> paths;
+	std::istringstream stream(list);
+	std::string path;
+	while(std::getline(stream, path))
+	{
+		if(!path.empty() && path[path.size() - 1] == '\r')
+			path.erase(path.size() - 1);
+		if(!path.empty())
+			paths.push_back(path);
+	}
+
+	fridh::module_loader loader;
+	std::vector<fridh::module_load_result> results;
+	bool success = loader.load(paths, results);
+
+	std::string data;
+	for(std::size_t i = 0; i < results.size(); i++)
+	{
+		fridh::module_load_result & result = results[i];
+		data += result.path + ": ";
+		if(result.loaded_module)
+			data += "loaded";
+		else
+			data += "error: " + result.error;
+		data += " (" + ail::number_to_string(result.time) + " us, thread " + ail::number_to_string(result.thread) + ")\n";
+	}
+	data += "Loaded " + ail::number_to_string(results.size()) + " module(s) in " + ail::number_to_string(loader.get_time()) + " us\n";
+	std::cout << data;
+
+	ail::write_file(output, data);
+	return success;
+}
+
 int main(int argc, char ** argv)
 {
 	if(argc != 4)
 	{
 		std::cout << argv[0] << " lexer <input> <output>" << std::endl;
+		std::cout << argv[0] << " stream-lexer <input> <output>" << std::endl;
 		std::cout << argv[0] << " parser <input> <output>" << std::endl;
+		std::cout << argv[0] << " flat <input> <output>" << std::endl;
+		std::cout << argv[0] << " loader <list of modules> <output>" << std::endl;
+		std::cout << argv[0] << " interpreter <input> <output>" << std::endl;
+		std::cout << argv[0] << " bytecode <input> <output>" << std::endl;
 		return 1;
 	}
 
@@ -75,8 +271,18 @@ int main(int argc, char ** argv)
 
 	if(command == "lexer")
 		perform_lexer_test(input, output);
+	else if(command == "stream-lexer")
+		perform_stream_lexer_test(input, output);
 	else if(command == "parser")
 		perform_parser_test(input, output);
+	else if(command == "flat")
+		perform_flat_test(input, output);
+	else if(command == "loader")
+		perform_loader_test(input, output);
+	else if(command == "interpreter")
+		perform_interpreter_test(input, output);
+	else if(command == "bytecode")
+		perform_bytecode_test(input, output);
 	else
 	{
 		std::cout << "Unknown command" << std::endl;
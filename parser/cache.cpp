@@ -0,0 +1,305 @@
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <ail/file.hpp>
+#include <ail/string.hpp>
+#include <fnv/fnv.hpp>
+#include <fridh/cache.hpp>
+#include <fridh/flat.hpp>
+#include <fridh/source.hpp>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace fridh
+{
+	namespace
+	{
+		struct cache_header
+		{
+			char magic[8];
+			boost::uint32_t format_version;
+			boost::uint32_t byte_order_mark;
+			boost::uint32_t word_size;
+			boost::uint32_t reserved;
+			boost::uint64_t source_hash;
+			boost::uint64_t source_size;
+			boost::uint64_t strings_size;
+			boost::uint64_t tree_size;
+		};
+
+		BOOST_STATIC_ASSERT(sizeof(cache_header) == 56);
+
+		char const cache_magic[8] = {'f', 'r', 'i', 'd', 'h', 'm', 'o', 'd'};
+		boost::uint32_t const byte_order_mark = 0x01020304;
+
+		//the arrays of the flat modules are stored as they are, so their layout must not depend on the compiler
+		BOOST_STATIC_ASSERT(sizeof(flat_range) == 8);
+		BOOST_STATIC_ASSERT(sizeof(flat_node) == 8);
+		BOOST_STATIC_ASSERT(sizeof(flat_constant) == 16);
+		BOOST_STATIC_ASSERT(sizeof(flat_symbol) == 8);
+		BOOST_STATIC_ASSERT(sizeof(flat_unary_operator_node) == 8);
+		BOOST_STATIC_ASSERT(sizeof(flat_binary_operator_node) == 12);
+		BOOST_STATIC_ASSERT(sizeof(flat_call) == 12);
+		BOOST_STATIC_ASSERT(sizeof(flat_unit) == 8);
+		BOOST_STATIC_ASSERT(sizeof(flat_if_statement) == 12);
+		BOOST_STATIC_ASSERT(sizeof(flat_if_else_statement) == 20);
+		BOOST_STATIC_ASSERT(sizeof(flat_for_each_statement) == 12);
+		BOOST_STATIC_ASSERT(sizeof(flat_for_statement) == 20);
+		BOOST_STATIC_ASSERT(sizeof(flat_while_statement) == 12);
+		BOOST_STATIC_ASSERT(sizeof(flat_function) == 16);
+		BOOST_STATIC_ASSERT(sizeof(flat_symbol_tree_node) == 20);
+
+		boost::atomic<uword> temporary_file_counter(0);
+
+		void corrupted_cache_error()
+		{
+			throw ail::exception("The module cache is corrupted");
+		}
+
+		//the order in which the arrays are stored in the file
+		template<typename module_type, typename visitor_type>
+		void visit_arrays(module_type & module, visitor_type & visitor)
+		{
+			visitor(module.symbol_tree_nodes);
+			visitor(module.functions);
+			visitor(module.argument_names);
+
+			visitor(module.units);
+			visitor(module.if_statements);
+			visitor(module.if_else_statements);
+			visitor(module.for_each_statements);
+			visitor(module.for_statements);
+			visitor(module.while_statements);
+
+			visitor(module.nodes);
+			visitor(module.constants);
+			visitor(module.symbols);
+			visitor(module.unary_operator_nodes);
+			visitor(module.binary_operator_nodes);
+			visitor(module.calls);
+			visitor(module.arrays);
+
+			visitor(module.strings);
+		}
+
+		class cache_writer
+		{
+		public:
+			std::string const & get_arrays() const
+			{
+				return arrays;
+			}
+
+			//each array is stored as its size followed by its elements
+			template<typename type>
+			void operator()(std::vector<type> const & input)
+			{
+				boost::uint32_t size = static_cast<boost::uint32_t>(input.size());
+				arrays.append(reinterpret_cast<char const *>(&size), sizeof(size));
+				if(!input.empty())
+					arrays.append(reinterpret_cast<char const *>(&input[0]), input.size() * sizeof(type));
+			}
+
+		private:
+			std::string arrays;
+		};
+
+		class cache_reader
+		{
+		public:
+			cache_reader(char const * arrays, std::size_t arrays_size):
+				arrays(arrays),
+				arrays_size(arrays_size),
+				offset(0)
+			{
+			}
+
+			bool is_complete() const
+			{
+				return offset == arrays_size;
+			}
+
+			template<typename type>
+			void operator()(std::vector<type> & output)
+			{
+				boost::uint32_t size;
+				if(arrays_size - offset < sizeof(size))
+					corrupted_cache_error();
+				std::memcpy(&size, arrays + offset, sizeof(size));
+				offset += sizeof(size);
+
+				if(size > (arrays_size - offset) / sizeof(type))
+					corrupted_cache_error();
+				output.resize(size);
+				if(size > 0)
+					std::memcpy(&output[0], arrays + offset, size * sizeof(type));
+				offset += size * sizeof(type);
+			}
+
+		private:
+			char const * arrays;
+			std::size_t
+				arrays_size,
+				offset;
+		};
+	}
+
+	module_cache::module_cache(std::string const & directory):
+		directory(directory)
+	{
+	}
+
+	bool module_cache::load(char const * source, std::size_t source_size, module & output) const
+	{
+		uword hash = get_source_hash(source, source_size);
+		source_buffer cache_file;
+		if(!cache_file.load(get_path(hash)))
+			return false;
+
+		return deserialise_module(cache_file.data(), cache_file.size(), hash, source_size, output);
+	}
+
+	bool module_cache::store(char const * source, std::size_t source_size, module const & input) const
+	{
+		uword hash = get_source_hash(source, source_size);
+		std::string data;
+		if(!serialise_module(input, hash, source_size, data))
+			return false;
+
+		//the file is written under a temporary name first so concurrent loads never see a partial file
+#ifdef _WIN32
+		uword process = static_cast<uword>(_getpid());
+#else
+		uword process = static_cast<uword>(getpid());
+#endif
+		std::string
+			path = get_path(hash),
+			temporary_path = path + "." + ail::number_to_string(process) + "." + ail::number_to_string(temporary_file_counter++) + ".tmp";
+
+		if(!ail::write_file(temporary_path, data))
+		{
+			std::remove(temporary_path.c_str());
+			return false;
+		}
+
+		if(std::rename(temporary_path.c_str(), path.c_str()) != 0)
+		{
+			//rename doesn't replace existing files on all platforms
+			std::remove(path.c_str());
+			if(std::rename(temporary_path.c_str(), path.c_str()) != 0)
+			{
+				std::remove(temporary_path.c_str());
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	std::string module_cache::get_path(char const * source, std::size_t source_size) const
+	{
+		return get_path(get_source_hash(source, source_size));
+	}
+
+	std::string module_cache::get_path(uword hash) const
+	{
+		std::ostringstream name;
+		name << std::hex << std::setw(16) << std::setfill('0') << hash << ".fridhc";
+		if(directory.empty())
+			return name.str();
+		return directory + "/" + name.str();
+	}
+
+	uword get_source_hash(char const * data, std::size_t size)
+	{
+		return fnv1a_hash(data, size, 0);
+	}
+
+	bool serialise_module(module const & input, uword source_hash, uword source_size, std::string & output)
+	{
+		flat_module flat;
+		try
+		{
+			flatten_module(input, flat);
+		}
+		catch(ail::exception &)
+		{
+			return false;
+		}
+
+		cache_writer writer;
+		visit_arrays(flat, writer);
+
+		std::string const
+			& strings = flat.characters,
+			& tree = writer.get_arrays();
+
+		cache_header header;
+		std::memcpy(header.magic, cache_magic, sizeof(header.magic));
+		header.format_version = static_cast<boost::uint32_t>(module_cache::format_version);
+		header.byte_order_mark = byte_order_mark;
+		header.word_size = sizeof(word);
+		header.reserved = 0;
+		header.source_hash = source_hash;
+		header.source_size = source_size;
+		header.strings_size = strings.size();
+		header.tree_size = tree.size();
+
+		output.clear();
+		output.reserve(sizeof(header) + strings.size() + tree.size());
+		output.append(reinterpret_cast<char const *>(&header), sizeof(header));
+		output += strings;
+		output += tree;
+		return true;
+	}
+
+	bool deserialise_module(char const * data, std::size_t size, uword source_hash, uword source_size, module & output)
+	{
+		cache_header header;
+		if(size < sizeof(header))
+			return false;
+		std::memcpy(&header, data, sizeof(header));
+
+		if
+		(
+			std::memcmp(header.magic, cache_magic, sizeof(header.magic)) != 0 ||
+			header.format_version != module_cache::format_version ||
+			header.byte_order_mark != byte_order_mark ||
+			header.word_size != sizeof(word) ||
+			header.source_hash != source_hash ||
+			header.source_size != source_size
+		)
+			return false;
+
+		std::size_t content_size = size - sizeof(header);
+		if(header.strings_size > content_size || header.tree_size != content_size - header.strings_size)
+			return false;
+
+		char const * strings = data + sizeof(header);
+		std::size_t strings_size = static_cast<std::size_t>(header.strings_size);
+
+		flat_module flat;
+		flat.characters.assign(strings, strings_size);
+		cache_reader reader(strings + strings_size, static_cast<std::size_t>(header.tree_size));
+		try
+		{
+			visit_arrays(flat, reader);
+			if(!reader.is_complete())
+				return false;
+			expand_module(flat, output);
+		}
+		catch(ail::exception &)
+		{
+			return false;
+		}
+		return true;
+	}
+}
@@ -20,11 +20,11 @@ namespace fridh
 		process_composite_term(conditional);
 
 		executable_units if_body;
-		process_body(&if_body);
+		process_nested_body(if_body);
 
 		bool is_if_else = false;
 
-		if(line_offset < line_end)
+		if(has_line(line_offset))
 		{
 			lexeme_container & lexemes = get_lexemes();
 			if(is_if_statement() && lexemes.size() == 1)
@@ -37,9 +37,9 @@ namespace fridh
 				output.type = executable_unit_type::if_else_statement;
 				if_else_statement * & if_else_pointer = output.if_else_pointer;
 				if_else_pointer = new if_else_statement;
-				if_else_pointer->conditional_term = conditional;
-				if_else_pointer->if_body = if_body;
-				if_else_pointer->else_body = else_body;
+				if_else_pointer->conditional_term.swap(conditional);
+				if_else_pointer->if_body.swap(if_body);
+				if_else_pointer->else_body.swap(else_body);
 			}
 		}
 
@@ -48,8 +48,8 @@ namespace fridh
 			output.type = executable_unit_type::if_statement;
 			if_statement * & if_pointer = output.if_pointer;
 			if_pointer = new if_statement;
-			if_pointer->conditional_term = conditional;
-			if_pointer->body = if_body;
+			if_pointer->conditional_term.swap(conditional);
+			if_pointer->body.swap(if_body);
 		}
 
 		return true;
@@ -67,9 +67,9 @@ namespace fridh
 		output.type = executable_unit_type::while_statement;
 		while_statement * & while_pointer = output.while_pointer;
 		while_pointer = new while_statement;
-		while_pointer->conditional_term = conditional;
+		while_pointer->conditional_term.swap(conditional);
 
-		process_body(&while_pointer->body);
+		process_nested_body(while_pointer->body);
 
 		return true;
 	}
@@ -84,7 +84,7 @@ namespace fridh
 		{
 			//three part for
 
-			if(lines.size() - line_offset < 4)
+			if(!has_line(line_offset + 3))
 				throw ail::exception("Incomplete for statement");
 
 			line_offset++;
@@ -101,6 +101,8 @@ namespace fridh
 			process_offset_atomic_statement(for_pointer->initialisation);
 			process_offset_atomic_statement(for_pointer->conditional);
 			process_offset_atomic_statement(for_pointer->iteration);
+
+			process_nested_body(for_pointer->body);
 		}
 		else
 		{
@@ -111,7 +113,7 @@ namespace fridh
 			for_each_pointer = new for_each_statement;
 			process_composite_term(for_each_pointer->container);
 
-			process_body(&for_each_pointer->body);
+			process_nested_body(for_each_pointer->body);
 		}
 
 		return true;
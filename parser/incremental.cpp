@@ -0,0 +1,554 @@
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <set>
+#include <ail/string.hpp>
+#include <fridh/incremental.hpp>
+#include <fridh/source.hpp>
+#include <fridh/lexer.hpp>
+#include <fridh/cache.hpp>
+
+namespace fridh
+{
+	namespace
+	{
+		std::size_t const no_match = static_cast<std::size_t>(-1);
+
+		/*
+		Lines which can't start a block: the else of an if statement (/), the scope operators and lines which continue a construct of the previous line (` and comments).
+		Merging two blocks is always safe, it only means that they have to be parsed again together.
+		*/
+		bool is_block_start(char input)
+		{
+			switch(input)
+			{
+				case ' ':
+				case '\t':
+				case '\r':
+				case '\n':
+				case ';':
+				case '/':
+				case '`':
+				case '(':
+				case ')':
+					return false;
+			}
+			return true;
+		}
+
+		//the body of a declaration or a control flow statement always includes the next line, no matter how it's indented
+		bool is_head(char input)
+		{
+			switch(input)
+			{
+				case '@':
+				case '$':
+				case '/':
+				case '\\':
+					return true;
+			}
+			return false;
+		}
+
+		namespace comment_state
+		{
+			enum type
+			{
+				none,
+				multi_line,
+				nested
+			};
+		}
+
+		struct source_block
+		{
+			std::size_t
+				offset,
+				size;
+			uword first_line;
+		};
+
+		void split_source(char const * data, std::size_t size, std::vector<source_block> & output)
+		{
+			source_block current_block;
+			current_block.offset = 0;
+			current_block.first_line = 1;
+
+			comment_state::type state = comment_state::none;
+			uword comment_depth = 0;
+			uword line = 1;
+			//lines which are part of the construct of a previous line, no matter how they are indented
+			uword pending_lines = 0;
+
+			for(std::size_t i = 0; i < size;)
+			{
+				std::size_t line_start = i;
+				bool
+					may_start_block = state == comment_state::none && is_block_start(data[i]),
+					has_content = false,
+					has_head = false,
+					is_for_head = false,
+					has_line_break = false;
+
+				while(i < size && data[i] != '\n')
+				{
+					char byte = data[i];
+
+					if(state == comment_state::multi_line)
+					{
+						if(byte == ';' && i + 1 < size && data[i + 1] == ';')
+						{
+							state = comment_state::none;
+							i += 2;
+						}
+						else
+							i++;
+						continue;
+					}
+					else if(state == comment_state::nested)
+					{
+						if(byte == ';' && i + 1 < size && data[i + 1] == '.')
+						{
+							comment_depth++;
+							i += 2;
+						}
+						else if(byte == '.' && i + 1 < size && data[i + 1] == ';')
+						{
+							comment_depth--;
+							if(comment_depth == 0)
+								state = comment_state::none;
+							i += 2;
+						}
+						else
+							i++;
+						continue;
+					}
+
+					switch(byte)
+					{
+						case '\t':
+							//the lexer treats tabs after the beginning of a line without indentation as the indentation of that line
+							may_start_block = false;
+							i++;
+							continue;
+
+						case ' ':
+						case '\r':
+							i++;
+							continue;
+
+						case ';':
+							if(i + 1 < size && data[i + 1] == ';')
+							{
+								state = comment_state::multi_line;
+								i += 2;
+							}
+							else if(i + 1 < size && data[i + 1] == '.')
+							{
+								state = comment_state::nested;
+								comment_depth = 1;
+								i += 2;
+							}
+							else
+							{
+								for(; i < size && data[i] != '\n'; i++);
+							}
+							continue;
+					}
+
+					if(has_content)
+						is_for_head = false;
+					else
+					{
+						has_content = true;
+						has_head = is_head(byte);
+						//a lone \ is the head of a for statement which consists of the three lines after it
+						is_for_head = byte == '\\' && !(i + 1 < size && data[i + 1] == '\\');
+					}
+
+					if(byte == '`')
+						has_line_break = true;
+					else if(byte == '\'' || byte == '"')
+					{
+						for(i++; i < size && data[i] != '\n'; i++)
+						{
+							if(data[i] == byte)
+								break;
+							else if(data[i] == '\\' && i + 1 < size && data[i + 1] != '\n')
+								i++;
+						}
+						if(i == size || data[i] == '\n')
+							continue;
+					}
+
+					i++;
+				}
+
+				if(has_content)
+				{
+					if(pending_lines > 0)
+						pending_lines--;
+					else if(may_start_block && line_start > current_block.offset)
+					{
+						current_block.size = line_start - current_block.offset;
+						output.push_back(current_block);
+						current_block.offset = line_start;
+						current_block.first_line = line;
+					}
+
+					//the line breaks within a line might also lead to the head of a for statement, the parts of a for statement are followed by its body
+					if(is_for_head || has_line_break)
+						pending_lines = 4;
+					else if(has_head && pending_lines == 0)
+						pending_lines = 1;
+				}
+
+				if(i < size)
+				{
+					i++;
+					line++;
+				}
+			}
+
+			if(size > current_block.offset || output.empty())
+			{
+				current_block.size = size - current_block.offset;
+				output.push_back(current_block);
+			}
+		}
+
+		void swap_symbols(symbol_tree_node & left, symbol_tree_node & right)
+		{
+			std::swap(left.type, right.type);
+			std::swap(left.function_pointer, right.function_pointer);
+			left.children.swap(right.children);
+			for(node_children::iterator i = left.children.begin(), end = left.children.end(); i != end; i++)
+				i->second->parent = &left;
+			for(node_children::iterator i = right.children.begin(), end = right.children.end(); i != end; i++)
+				i->second->parent = &right;
+		}
+	}
+
+	incremental_parser::block::block():
+		hash(0),
+		offset(0),
+		size(0),
+		first_line(1),
+		unit_count(0),
+		arena_size(0)
+	{
+	}
+
+	incremental_parser::incremental_parser(std::string const & name, module & output):
+		name(name),
+		output(output),
+		parsed_block_count(0),
+		garbage_size(0)
+	{
+		output.path = name;
+	}
+
+	bool incremental_parser::process_module(std::string const & path, std::string & error_message)
+	{
+		source_buffer source_file;
+		if(!source_file.load(path))
+		{
+			error_message = "Unable to read file \"" + path + "\"";
+			return false;
+		}
+
+		output.path = path;
+		return process_data(source_file.data(), source_file.size(), error_message);
+	}
+
+	bool incremental_parser::process_data(char const * data, std::size_t size, std::string & error_message)
+	{
+		bool success = update(data, size, output, error_message);
+
+		//the nodes of the replaced blocks are only released once they take up as much memory as the live ones
+		if(garbage_size > output.arena.get_size() / 2)
+			compact();
+
+		return success;
+	}
+
+	std::size_t incremental_parser::get_block_count() const
+	{
+		return blocks.size();
+	}
+
+	std::size_t incremental_parser::get_parsed_block_count() const
+	{
+		return parsed_block_count;
+	}
+
+	bool incremental_parser::update(char const * data, std::size_t size, module & target, std::string & error_message)
+	{
+		std::vector<source_block> source_blocks;
+		split_source(data, size, source_blocks);
+
+		block_vector new_blocks(source_blocks.size());
+		for(std::size_t i = 0; i < source_blocks.size(); i++)
+		{
+			source_block & current_source_block = source_blocks[i];
+			block & new_block = new_blocks[i];
+			new_block.offset = current_source_block.offset;
+			new_block.size = current_source_block.size;
+			new_block.first_line = current_source_block.first_line;
+			new_block.hash = get_source_hash(data + new_block.offset, new_block.size);
+		}
+
+		//blocks are matched by their content, not their position, so lines inserted above a block don't affect it
+		typedef std::multimap<uword, std::size_t> hash_map;
+		hash_map old_hashes;
+		for(std::size_t i = 0; i < blocks.size(); i++)
+			old_hashes.insert(hash_map::value_type(blocks[i].hash, i));
+
+		std::vector<std::size_t> matches(new_blocks.size(), no_match);
+		std::vector<bool> is_matched(blocks.size(), false);
+		for(std::size_t i = 0; i < new_blocks.size(); i++)
+		{
+			block & new_block = new_blocks[i];
+			std::pair<hash_map::iterator, hash_map::iterator> range = old_hashes.equal_range(new_block.hash);
+			for(hash_map::iterator j = range.first; j != range.second; j++)
+			{
+				block & old_block = blocks[j->second];
+				if(old_block.size == new_block.size && std::memcmp(source.data() + old_block.offset, data + new_block.offset, new_block.size) == 0)
+				{
+					matches[i] = j->second;
+					is_matched[j->second] = true;
+					old_hashes.erase(j);
+					break;
+				}
+			}
+		}
+
+		std::set<atom> removed_names;
+		for(std::size_t i = 0; i < blocks.size(); i++)
+		{
+			if(!is_matched[i])
+				removed_names.insert(blocks[i].names.begin(), blocks[i].names.end());
+		}
+
+		//all the new blocks are lexed before any of them is parsed since errors of the lexer take precedence over those of the parser
+		std::vector<lines_of_code> new_lines(new_blocks.size());
+		for(std::size_t i = 0; i < new_blocks.size(); i++)
+		{
+			if(matches[i] != no_match)
+				continue;
+
+			block & new_block = new_blocks[i];
+			lexer block_lexer(data + new_block.offset, new_block.size, new_lines[i], true);
+			block_lexer.set_first_line(new_block.first_line);
+			if(!block_lexer.parse(error_message))
+			{
+				parsed_block_count = 0;
+				return false;
+			}
+		}
+
+		//the new blocks are parsed in order so the first error is the same as the one of a full parse
+		symbol_tree_node new_symbols;
+		std::vector<executable_units> new_bodies(new_blocks.size());
+		std::size_t parsed_blocks = 0;
+		uword initial_arena_size = target.arena.get_size();
+		bool success = true;
+		//name collisions are only reported if none of the blocks contain any other errors, the one found first by a full parse is the one with the lowest line
+		uword collision_line = 0;
+		std::string collision_message;
+		{
+			arena_scope scope(target.arena);
+
+			for(std::size_t i = 0; i < new_blocks.size(); i++)
+			{
+				if(matches[i] != no_match)
+					continue;
+
+				block & new_block = new_blocks[i];
+				if(collision_line != 0 && collision_line <= new_block.first_line)
+					break;
+
+				symbol_tree_node block_symbols;
+				uword arena_size = target.arena.get_size();
+				bool block_success = block_parser.process_lines(new_lines[i], name, block_symbols, new_bodies[i], error_message);
+				new_block.arena_size = target.arena.get_size() - arena_size;
+				new_block.unit_count = new_bodies[i].size();
+				parsed_blocks++;
+
+				//the names of the unchanged blocks are still in the module while the new ones are only in the temporary tree
+				for(node_children::iterator j = block_symbols.children.begin(), end = block_symbols.children.end(); j != end; j++)
+				{
+					atom symbol_name = j->first;
+					if(new_symbols.exists(symbol_name) || (target.symbols.exists(symbol_name) && removed_names.find(symbol_name) == removed_names.end()))
+					{
+						//a full parse reports the later one of the two declarations
+						uword line = new_block.first_line;
+						for(std::size_t k = i + 1; k < new_blocks.size(); k++)
+						{
+							if(matches[k] == no_match)
+								continue;
+
+							atom_vector const & names = blocks[matches[k]].names;
+							if(std::find(names.begin(), names.end(), symbol_name) != names.end())
+							{
+								line = new_blocks[k].first_line;
+								break;
+							}
+						}
+
+						if(collision_line == 0 || line < collision_line)
+						{
+							collision_line = line;
+							collision_message = name + ": Line " + ail::number_to_string(line) + ": Name \"" + get_atom_string(symbol_name) + "\" has already been used by another function or class in the current scope";
+						}
+						continue;
+					}
+
+					if(block_success)
+					{
+						new_block.names.push_back(symbol_name);
+						new_symbols.children[symbol_name] = j->second;
+						j->second = 0;
+					}
+				}
+
+				//the declarations are checked before their bodies are parsed so a collision in the head of the block comes first
+				if(!block_success)
+				{
+					if(collision_line == 0 || collision_line > new_block.first_line)
+						success = false;
+					break;
+				}
+			}
+		}
+
+		if(success && collision_line != 0)
+		{
+			error_message = collision_message;
+			success = false;
+		}
+
+		parsed_block_count = parsed_blocks;
+
+		if(!success)
+		{
+			//everything parsed up to the error is left behind in the arena
+			garbage_size += target.arena.get_size() - initial_arena_size;
+			return false;
+		}
+
+		//the update can't fail anymore, the declarations of the removed blocks are replaced by the new ones
+		bool rebuild_body = false;
+		std::vector<std::size_t> unit_offsets(blocks.size());
+		std::size_t unit_offset = 0;
+		for(std::size_t i = 0; i < blocks.size(); i++)
+		{
+			block & old_block = blocks[i];
+			unit_offsets[i] = unit_offset;
+			unit_offset += old_block.unit_count;
+			if(is_matched[i])
+				continue;
+
+			for(atom_vector::iterator j = old_block.names.begin(), end = old_block.names.end(); j != end; j++)
+			{
+				node_children::iterator iterator = target.symbols.children.find(*j);
+				delete iterator->second;
+				target.symbols.children.erase(iterator);
+			}
+
+			if(old_block.unit_count > 0)
+				rebuild_body = true;
+			garbage_size += old_block.arena_size;
+		}
+
+		for(node_children::iterator i = new_symbols.children.begin(), end = new_symbols.children.end(); i != end; i++)
+		{
+			i->second->parent = &target.symbols;
+			target.symbols.children[i->first] = i->second;
+		}
+		new_symbols.children.clear();
+
+		//the entry function only has to be put together again if its statements changed or moved
+		std::size_t last_match = 0;
+		for(std::size_t i = 0; !rebuild_body && i < new_blocks.size(); i++)
+		{
+			block & new_block = new_blocks[i];
+			if(matches[i] == no_match)
+				rebuild_body = new_block.unit_count > 0;
+			else if(blocks[matches[i]].unit_count > 0)
+			{
+				rebuild_body = matches[i] < last_match;
+				last_match = matches[i];
+			}
+		}
+
+		if(rebuild_body)
+		{
+			executable_units & old_body = target.entry_function.body;
+			executable_units body;
+			for(std::size_t i = 0; i < new_blocks.size(); i++)
+			{
+				std::size_t match = matches[i];
+				if(match == no_match)
+				{
+					executable_units & new_body = new_bodies[i];
+					for(executable_units::iterator j = new_body.begin(), end = new_body.end(); j != end; j++)
+						move_back(body, *j);
+				}
+				else
+				{
+					for(std::size_t j = unit_offsets[match], end = j + blocks[match].unit_count; j < end; j++)
+						move_back(body, old_body[j]);
+				}
+			}
+			old_body.swap(body);
+		}
+
+		for(std::size_t i = 0; i < new_blocks.size(); i++)
+		{
+			std::size_t match = matches[i];
+			if(match == no_match)
+				continue;
+
+			block & old_block = blocks[match];
+			block & new_block = new_blocks[i];
+			new_block.names.swap(old_block.names);
+			new_block.unit_count = old_block.unit_count;
+			new_block.arena_size = old_block.arena_size;
+		}
+
+		blocks.swap(new_blocks);
+		source.assign(data, size);
+
+		return true;
+	}
+
+	void incremental_parser::compact()
+	{
+		//the current source is parsed again from scratch into a new module which then takes the place of the old one
+		block_vector current_blocks;
+		current_blocks.swap(blocks);
+		std::string current_source;
+		current_source.swap(source);
+		std::size_t current_parsed_block_count = parsed_block_count;
+
+		module new_module;
+		std::string error_message;
+		if(!update(current_source.data(), current_source.size(), new_module, error_message))
+		{
+			//the source was parsed successfully before so this shouldn't happen, the old module remains usable anyway
+			blocks.swap(current_blocks);
+			source.swap(current_source);
+			parsed_block_count = current_parsed_block_count;
+			return;
+		}
+
+		output.arena.swap(new_module.arena);
+		swap_symbols(output.symbols, new_module.symbols);
+		output.entry_function.arguments.swap(new_module.entry_function.arguments);
+		output.entry_function.body.swap(new_module.entry_function.body);
+
+		parsed_block_count = current_parsed_block_count;
+		garbage_size = 0;
+	}
+}
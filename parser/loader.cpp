@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <fridh/loader.hpp>
+#include <boost/bind/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+namespace fridh
+{
+	namespace
+	{
+		uword get_microseconds(boost::posix_time::ptime start)
+		{
+			return static_cast<uword>((boost::posix_time::microsec_clock::universal_time() - start).total_microseconds());
+		}
+	}
+
+	module_load_result::module_load_result():
+		time(0),
+		thread(0)
+	{
+	}
+
+	module_loader::module_loader(std::size_t thread_count, module_cache const * cache):
+		thread_count(thread_count),
+		cache(cache),
+		time(0),
+		use_pipelines(false),
+		paths(0),
+		results(0)
+	{
+		if(this->thread_count == 0)
+			this->thread_count = std::max<std::size_t>(boost::thread::hardware_concurrency(), 1);
+	}
+
+	bool module_loader::load(std::vector<std::string> const & paths, std::vector<module_load_result> & results)
+	{
+		boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+
+		this->paths = &paths;
+		this->results = &results;
+		results.clear();
+		results.resize(paths.size());
+
+		std::size_t worker_count = std::min(thread_count, paths.size());
+		use_pipelines = 2 * worker_count <= thread_count;
+		for(std::size_t i = 0; i < worker_count; i++)
+			queues.push_back(new work_queue);
+
+		//contiguous ranges keep the workers out of each other's queues until they run out of work
+		for(std::size_t i = 0; i < paths.size(); i++)
+			queues[i * worker_count / paths.size()]->tasks.push_back(i);
+
+		if(worker_count == 1)
+			work(0);
+		else if(worker_count > 1)
+		{
+			boost::thread_group threads;
+			for(std::size_t i = 0; i < worker_count; i++)
+				threads.create_thread(boost::bind(&module_loader::work, this, i));
+			threads.join_all();
+		}
+
+		for(std::size_t i = 0; i < queues.size(); i++)
+			delete queues[i];
+		queues.clear();
+
+		this->paths = 0;
+		this->results = 0;
+
+		time = get_microseconds(start);
+
+		for(std::size_t i = 0; i < results.size(); i++)
+		{
+			if(!results[i].loaded_module)
+				return false;
+		}
+		return true;
+	}
+
+	uword module_loader::get_time() const
+	{
+		return time;
+	}
+
+	void module_loader::work(std::size_t worker)
+	{
+		std::size_t pipeline_threshold = parser::no_pipeline;
+		if(use_pipelines)
+			pipeline_threshold = parser::default_pipeline_threshold;
+
+		parser current_parser(pipeline_threshold);
+		current_parser.set_cache(cache);
+		std::size_t task;
+		while(get_task(worker, task))
+			load_module(task, worker, current_parser);
+	}
+
+	bool module_loader::get_task(std::size_t worker, std::size_t & task)
+	{
+		{
+			work_queue & own_queue = *queues[worker];
+			boost::mutex::scoped_lock scoped_lock(own_queue.mutex);
+			if(!own_queue.tasks.empty())
+			{
+				task = own_queue.tasks.front();
+				own_queue.tasks.pop_front();
+				return true;
+			}
+		}
+
+		//steal from the end of the other queues, which is the work their owners would get to last
+		for(std::size_t i = 1; i < queues.size(); i++)
+		{
+			work_queue & other_queue = *queues[(worker + i) % queues.size()];
+			boost::mutex::scoped_lock scoped_lock(other_queue.mutex);
+			if(!other_queue.tasks.empty())
+			{
+				task = other_queue.tasks.back();
+				other_queue.tasks.pop_back();
+				return true;
+			}
+		}
+
+		//no tasks are added during a load so there is nothing left to do
+		return false;
+	}
+
+	void module_loader::load_module(std::size_t task, std::size_t worker, parser & current_parser)
+	{
+		boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+
+		std::string const & path = (*paths)[task];
+		module_load_result & result = (*results)[task];
+		result.path = path;
+		result.thread = worker;
+
+		boost::shared_ptr<module> new_module(new module);
+		if(current_parser.process_module(path, path, *new_module, result.error))
+			result.loaded_module = new_module;
+
+		result.time = get_microseconds(start);
+	}
+}
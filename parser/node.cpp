@@ -1,68 +1,79 @@
-#include <map>
+#include <algorithm>
+#include <boost/thread/once.hpp>
 #include <fridh/symbol.hpp>
 #include <fridh/lexer.hpp>
 
 namespace fridh
 {
-	typedef std::map<lexeme_type::type, unary_operator_type::type> unary_lexeme_map_type;
-	typedef std::map<lexeme_type::type, binary_operator_type::type> binary_lexeme_map_type;
-
 	using namespace lexeme_type;
 
 	namespace
 	{
-		bool maps_are_initialised = false;
+		//must follow the last lexeme type
+		std::size_t const lexeme_type_count = static_cast<std::size_t>(spaced_call_operator) + 1;
 
-		unary_lexeme_map_type unary_lexeme_map;
-		binary_lexeme_map_type binary_lexeme_map;
-	}
+		//the operator types of the lexemes indexed by the lexeme type, -1 marks lexemes which aren't operators
+		int unary_lexeme_table[lexeme_type_count];
+		int binary_lexeme_table[lexeme_type_count];
 
-	void initialise_maps()
-	{
-		if(maps_are_initialised)
-			return;
-
-		unary_lexeme_map[logical_not] = unary_operator_type::logical_not;
-		unary_lexeme_map[binary_not] = unary_operator_type::binary_not;
-
-		unary_lexeme_map[increment] = unary_operator_type::increment;
-		unary_lexeme_map[decrement] = unary_operator_type::decrement;
-
-		binary_lexeme_map[addition] = binary_operator_type::addition;
-		binary_lexeme_map[subtraction] = binary_operator_type::subtraction;
-		binary_lexeme_map[multiplication] = binary_operator_type::multiplication;
-		binary_lexeme_map[division] = binary_operator_type::division;
-		binary_lexeme_map[modulo] = binary_operator_type::modulo;
-		binary_lexeme_map[exponentiation] = binary_operator_type::exponentiation;
-
-		binary_lexeme_map[less_than] = binary_operator_type::less_than;
-		binary_lexeme_map[less_than_or_equal] = binary_operator_type::less_than_or_equal;
-		binary_lexeme_map[greater_than] = binary_operator_type::greater_than;
-		binary_lexeme_map[greater_than_or_equal] = binary_operator_type::greater_than_or_equal;
-		binary_lexeme_map[not_equal] = binary_operator_type::not_equal;
-		binary_lexeme_map[equal] = binary_operator_type::equal;
-
-		binary_lexeme_map[logical_and] = binary_operator_type::logical_and;
-		binary_lexeme_map[logical_or] = binary_operator_type::logical_or;
-
-		binary_lexeme_map[shift_left] = binary_operator_type::shift_left;
-		binary_lexeme_map[shift_right] = binary_operator_type::shift_right;
-
-		binary_lexeme_map[binary_and] = binary_operator_type::binary_and;
-		binary_lexeme_map[binary_or] = binary_operator_type::binary_or;
-		binary_lexeme_map[binary_xor] = binary_operator_type::binary_xor;
-
-		binary_lexeme_map[dot] = binary_operator_type::selection;
-
-		binary_lexeme_map[assignment] = binary_operator_type::assignment;
-		binary_lexeme_map[addition_assignment] = binary_operator_type::addition_assignment;
-		binary_lexeme_map[subtraction_assignment] = binary_operator_type::subtraction_assignment;
-		binary_lexeme_map[multiplication_assignment] = binary_operator_type::multiplication_assignment;
-		binary_lexeme_map[division_assignment] = binary_operator_type::division_assignment;
-		binary_lexeme_map[modulo_assignment] = binary_operator_type::modulo_assignment;
-		binary_lexeme_map[exponentiation_assignment] = binary_operator_type::exponentiation_assignment;
-
-		maps_are_initialised = true;
+		boost::once_flag operator_tables_flag = BOOST_ONCE_INIT;
+
+		void build_operator_tables()
+		{
+			std::fill(unary_lexeme_table, unary_lexeme_table + lexeme_type_count, -1);
+			std::fill(binary_lexeme_table, binary_lexeme_table + lexeme_type_count, -1);
+
+			unary_lexeme_table[negation] = unary_operator_type::negation;
+			unary_lexeme_table[logical_not] = unary_operator_type::logical_not;
+			unary_lexeme_table[binary_not] = unary_operator_type::binary_not;
+
+			unary_lexeme_table[increment] = unary_operator_type::increment;
+			unary_lexeme_table[decrement] = unary_operator_type::decrement;
+
+			binary_lexeme_table[addition] = binary_operator_type::addition;
+			binary_lexeme_table[subtraction] = binary_operator_type::subtraction;
+			binary_lexeme_table[multiplication] = binary_operator_type::multiplication;
+			binary_lexeme_table[division] = binary_operator_type::division;
+			binary_lexeme_table[modulo] = binary_operator_type::modulo;
+			binary_lexeme_table[exponentiation] = binary_operator_type::exponentiation;
+
+			binary_lexeme_table[less_than] = binary_operator_type::less_than;
+			binary_lexeme_table[less_than_or_equal] = binary_operator_type::less_than_or_equal;
+			binary_lexeme_table[greater_than] = binary_operator_type::greater_than;
+			binary_lexeme_table[greater_than_or_equal] = binary_operator_type::greater_than_or_equal;
+			binary_lexeme_table[not_equal] = binary_operator_type::not_equal;
+			binary_lexeme_table[equal] = binary_operator_type::equal;
+
+			binary_lexeme_table[logical_and] = binary_operator_type::logical_and;
+			binary_lexeme_table[logical_or] = binary_operator_type::logical_or;
+
+			binary_lexeme_table[shift_left] = binary_operator_type::shift_left;
+			binary_lexeme_table[shift_right] = binary_operator_type::shift_right;
+
+			binary_lexeme_table[binary_and] = binary_operator_type::binary_and;
+			binary_lexeme_table[binary_or] = binary_operator_type::binary_or;
+			binary_lexeme_table[binary_xor] = binary_operator_type::binary_xor;
+
+			binary_lexeme_table[dot] = binary_operator_type::selection;
+
+			binary_lexeme_table[assignment] = binary_operator_type::assignment;
+			binary_lexeme_table[addition_assignment] = binary_operator_type::addition_assignment;
+			binary_lexeme_table[subtraction_assignment] = binary_operator_type::subtraction_assignment;
+			binary_lexeme_table[multiplication_assignment] = binary_operator_type::multiplication_assignment;
+			binary_lexeme_table[division_assignment] = binary_operator_type::division_assignment;
+			binary_lexeme_table[modulo_assignment] = binary_operator_type::modulo_assignment;
+			binary_lexeme_table[exponentiation_assignment] = binary_operator_type::exponentiation_assignment;
+		}
+
+		int get_operator(int const * table, lexeme_type::type input)
+		{
+			boost::call_once(operator_tables_flag, &build_operator_tables);
+
+			std::size_t index = static_cast<std::size_t>(input);
+			if(index >= lexeme_type_count)
+				return -1;
+			return table[index];
+		}
 	}
 
 	void lexeme_to_argument_node(lexeme & input, parse_tree_node & output)
@@ -72,7 +83,7 @@ namespace fridh
 			output.type = parse_tree_node_type::symbol;
 			parse_tree_symbol * & symbol_pointer = output.symbol_pointer;
 			symbol_pointer = new parse_tree_symbol;
-			symbol_pointer->name = *input.string;
+			symbol_pointer->name = input.name;
 		}
 		else
 		{
@@ -102,7 +113,7 @@ namespace fridh
 					break;
 
 				case string:
-					new_variable->new_string(*input.string);
+					new_variable->new_string(input.get_string());
 					break;
 
 				default:
@@ -116,29 +127,25 @@ namespace fridh
 
 	void lexeme_to_unary_operator_node(lexeme & input, parse_tree_node & output)
 	{
-		initialise_maps();
-
-		unary_lexeme_map_type::iterator iterator = unary_lexeme_map.find(input.type);
-		if(iterator == unary_lexeme_map.end())
+		int operator_type = get_operator(unary_lexeme_table, input.type);
+		if(operator_type == -1)
 			throw ail::exception("Unknown lexeme type encountered while trying to match it to a corresponding unary operator parse tree node type");
 
 		output.type = parse_tree_node_type::unary_operator_node;
 		parse_tree_unary_operator_node * & unary_operator_pointer = output.unary_operator_pointer;
 		unary_operator_pointer = new parse_tree_unary_operator_node;
-		unary_operator_pointer->type = iterator->second;
+		unary_operator_pointer->type = static_cast<unary_operator_type::type>(operator_type);
 	}
 
 	void lexeme_to_binary_operator_node(lexeme & input, parse_tree_node & output)
 	{
-		initialise_maps();
-
-		binary_lexeme_map_type::iterator iterator = binary_lexeme_map.find(input.type);
-		if(iterator == binary_lexeme_map.end())
+		int operator_type = get_operator(binary_lexeme_table, input.type);
+		if(operator_type == -1)
 			throw ail::exception("Unknown lexeme type encountered while trying to match it to a corresponding binary operator parse tree node type");
 
 		output.type = parse_tree_node_type::binary_operator_node;
 		parse_tree_binary_operator_node * & binary_operator_pointer = output.binary_operator_pointer;
 		binary_operator_pointer = new parse_tree_binary_operator_node;
-		binary_operator_pointer->type = iterator->second;
+		binary_operator_pointer->type = static_cast<binary_operator_type::type>(operator_type);
 	}
 }
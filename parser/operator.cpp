@@ -1,3 +1,4 @@
+#include <limits>
 #include <ail/file.hpp>
 #include <ail/string.hpp>
 #include <fridh/parser.hpp>
@@ -5,148 +6,224 @@
 
 namespace fridh
 {
-	void call_check(std::size_t extremum_offset)
-	{
-		if(extremum_offset != 1)
-			throw ail::exception("Invalid call offset encountered during operator resolution");
-	}
+	/*
+	The nodes of a statement are resolved in a single pass by precedence climbing:
+
+	expression: operand {binary_operator expression}
+	operand: chain {. chain}
+	chain: element {call | , [element]}
+	element: {prefix_unary_operator} argument [post_fix_operator]
 
-	void visualise_parse_tree_nodes(parse_tree_nodes & input)
+	Prefix unary operators only ever apply to the argument right after them and the post fix operators to the one right before them, e.g. -a.b is (-a).b.
+	The binary operators are resolved according to their precedence, chains of equal precedence are grouped from left to right unless the operator is right-to-left, e.g. a = b = c.
+	*/
+
+	namespace
 	{
-		for(std::size_t i = 0; i < input.size(); i++)
-			std::cout << (i + 1) << ". " << input[i].to_string() << std::endl;
+		//nodes which are already resolved (e.g. bracketed terms) are treated as arguments
+		bool is_operator_node(parse_tree_node const & input)
+		{
+			switch(input.type)
+			{
+				case parse_tree_node_type::unary_operator_node:
+					return input.unary_operator_pointer->argument.type == parse_tree_node_type::uninitialised;
+
+				case parse_tree_node_type::binary_operator_node:
+					return input.binary_operator_pointer->left_argument.type == parse_tree_node_type::uninitialised;
+
+				case parse_tree_node_type::call:
+					return input.call_pointer->function.type == parse_tree_node_type::uninitialised;
+
+				case parse_tree_node_type::call_operator:
+					return true;
+
+				default:
+					return false;
+			}
+		}
+
+		bool is_binary_operator_node(parse_tree_node const & input)
+		{
+			return
+				input.type == parse_tree_node_type::binary_operator_node &&
+				is_operator_node(input)
+			;
+		}
+
+		bool is_selection_operator_node(parse_tree_node const & input)
+		{
+			return
+				is_binary_operator_node(input) &&
+				input.binary_operator_pointer->type == binary_operator_type::selection
+			;
+		}
+
+		bool is_unary_operator_node(parse_tree_node const & input, bool post_fix)
+		{
+			return
+				input.type == parse_tree_node_type::unary_operator_node &&
+				is_operator_node(input) &&
+				input.is_post_fix() == post_fix
+			;
+		}
+
+		bool is_element_start(parse_tree_node const & input)
+		{
+			return
+				!is_operator_node(input) ||
+				is_unary_operator_node(input, false)
+			;
+		}
 	}
 
 	void parser::operator_resolution(parse_tree_nodes & input, parse_tree_node & output)
 	{
 		if(input.size() == 1)
 		{
-			output = input[0];
+			output.swap(input[0]);
 			return;
 		}
 
-		bool got_an_operator = false;
-		word extremum;
-		std::size_t extremum_offset;
-
-		for(std::size_t i = 0, end = input.size(); i < end; i++)
-		{
-			parse_tree_node & current_node = input[i];
-			word precedence;
-
-			bool is_initialised_unary_node =
-				current_node.type == parse_tree_node_type::unary_operator_node &&
-				current_node.unary_operator_pointer->argument.type != parse_tree_node_type::uninitialised
-			;
+		std::size_t offset = 0;
+		resolve_expression(input, offset, std::numeric_limits<word>::max(), output);
+		if(offset != input.size())
+			error("Failed to perform operator resolution");
+	}
 
-			bool is_initialised_call_node =
-				current_node.type == parse_tree_node_type::call &&
-				i == 0;
+	void parser::resolve_expression(parse_tree_nodes & input, std::size_t & offset, word maximum_precedence, parse_tree_node & output)
+	{
+		resolve_operand(input, offset, output);
 
-			if
-			(
-				is_initialised_unary_node ||
-				is_initialised_call_node
-			)
-				continue;
+		while(offset < input.size())
+		{
+			parse_tree_node & operator_node = input[offset];
+			if(!is_binary_operator_node(operator_node))
+				break;
 
+			word precedence;
 			try
 			{
-				if(get_parse_tree_node_precedence(current_node, precedence))
-				{
-					if
-					(
-						!got_an_operator ||
-						precedence > extremum ||
-						(is_right_to_left_operator(current_node) && precedence == extremum)
-					)
-					{
-						got_an_operator = true;
-						extremum = precedence;
-						extremum_offset = i;
-					}
-				}
+				get_parse_tree_node_precedence(operator_node, precedence);
 			}
 			catch(ail::exception & exception)
 			{
 				error(exception.get_message());
 			}
-		}
-
-		if(!got_an_operator)
-			error("Failed to perform operator resolution");
-
-		parse_tree_node & operator_node = input[extremum_offset];
-		std::size_t next_offset = extremum_offset + 1;
-		switch(operator_node.type)
-		{
-			case parse_tree_node_type::unary_operator_node:
-			{
-				std::size_t argument_offset;
-				if(operator_node.is_post_fix())
-					argument_offset = extremum_offset - 1;
-				else
-					argument_offset = next_offset;
 
-				if(argument_offset >= input.size())
-					error("Missing operator for unary argument");
-
-				parse_tree_unary_operator_node & unary_operator_node = *operator_node.unary_operator_pointer;
-				unary_operator_node.argument = input[argument_offset];
-				input.erase(input.begin() + argument_offset);
+			if(precedence > maximum_precedence)
 				break;
-			}
-		
-			case parse_tree_node_type::binary_operator_node:
-			{
-				parse_tree_binary_operator_node & binary_operator_node = *operator_node.binary_operator_pointer;
 
-				if(extremum_offset == 0)
-					error("Encountered a binary operator which lacks a left hand argument");
-				else if(next_offset >= input.size())
-					error("Encountered a binary operator which lacks a right hand argument");
+			offset++;
+			if(offset >= input.size())
+				error("Encountered a binary operator which lacks a right hand argument");
 
-				parse_tree_nodes
-					left_side(input.begin(), input.begin() + extremum_offset),
-					right_side(input.begin() + next_offset, input.end());
+			//the right hand side of a left-to-right operator may only contain operators which bind more tightly so the next operator of equal precedence becomes the root, e.g. (a - b) - c
+			word right_maximum_precedence = precedence;
+			if(!is_right_to_left_operator(operator_node))
+				right_maximum_precedence--;
 
-				operator_resolution(left_side, binary_operator_node.left_argument);
-				operator_resolution(right_side, binary_operator_node.right_argument);
+			parse_tree_binary_operator_node & binary_operator_node = *operator_node.binary_operator_pointer;
+			binary_operator_node.left_argument.swap(output);
+			resolve_expression(input, offset, right_maximum_precedence, binary_operator_node.right_argument);
+			output.swap(operator_node);
+		}
+	}
 
-				output = operator_node;
+	void parser::resolve_operand(parse_tree_nodes & input, std::size_t & offset, parse_tree_node & output)
+	{
+		resolve_chain(input, offset, output);
 
-				return;
-			}
+		while(offset < input.size() && is_selection_operator_node(input[offset]))
+		{
+			parse_tree_node & operator_node = input[offset];
+			offset++;
+			if(offset >= input.size())
+				error("Encountered a binary operator which lacks a right hand argument");
+
+			parse_tree_binary_operator_node & binary_operator_node = *operator_node.binary_operator_pointer;
+			binary_operator_node.left_argument.swap(output);
+			resolve_chain(input, offset, binary_operator_node.right_argument);
+			output.swap(operator_node);
+		}
+	}
 
-			case parse_tree_node_type::call:
-				call_check(extremum_offset);
-				operator_node.call_pointer->function = input[0];
-				input.erase(input.begin());
-				break;
+	void parser::resolve_chain(parse_tree_nodes & input, std::size_t & offset, parse_tree_node & output)
+	{
+		resolve_element(input, offset, output);
 
-			case parse_tree_node_type::call_operator:
-			case parse_tree_node_type::spaced_call_operator:
+		while(offset < input.size())
+		{
+			parse_tree_node & operator_node = input[offset];
+			if(operator_node.type == parse_tree_node_type::call && is_operator_node(operator_node))
+				offset++;
+			else if(operator_node.type == parse_tree_node_type::call_operator)
 			{
-				call_check(extremum_offset);
 				operator_node.is_call();
-				operator_node.call_pointer->function = input[0];
-				input.erase(input.begin());
+				offset++;
 
-				parse_tree_node & new_operator_node = input[0];
-
-				next_offset--;
-				if(new_operator_node.type != parse_tree_node_type::spaced_call_operator && next_offset < input.size())
+				//the argument of the call operator is optional, e.g. "f," calls f without any arguments
+				if(offset < input.size() && is_element_start(input[offset]))
 				{
-					new_operator_node.call_pointer->arguments.push_back(input[next_offset]);
-					input.erase(input.begin() + next_offset);
+					parse_tree_node argument;
+					resolve_element(input, offset, argument);
+					move_back(operator_node.call_pointer->arguments, argument);
 				}
+			}
+			else
 				break;
+
+			operator_node.call_pointer->function.swap(output);
+			output.swap(operator_node);
+		}
+	}
+
+	void parser::resolve_element(parse_tree_nodes & input, std::size_t & offset, parse_tree_node & output)
+	{
+		std::size_t prefix_offset = offset;
+		while(offset < input.size() && is_unary_operator_node(input[offset], false))
+			offset++;
+
+		if(offset >= input.size())
+			error("Missing operator for unary argument");
+
+		parse_tree_node & argument = input[offset];
+		if(is_operator_node(argument))
+		{
+			switch(argument.type)
+			{
+				case parse_tree_node_type::unary_operator_node:
+					error("Missing operator for unary argument");
+					break;
+
+				case parse_tree_node_type::binary_operator_node:
+					error("Encountered a binary operator which lacks a left hand argument");
+					break;
+
+				default:
+					error("Invalid call offset encountered during operator resolution");
+					break;
 			}
+		}
+
+		output.swap(argument);
+		std::size_t argument_offset = offset;
+		offset++;
 
-			default:
-				error("Invalid operator node type encountered during operator resolution");
+		//post-fix operators bind more tightly than prefix operators, e.g. -x++ is -(x++)
+		if(offset < input.size() && is_unary_operator_node(input[offset], true))
+		{
+			parse_tree_node & operator_node = input[offset];
+			operator_node.unary_operator_pointer->argument.swap(output);
+			output.swap(operator_node);
+			offset++;
 		}
 
-		operator_resolution(input, output);
+		//the prefix operators are applied from the inside out, e.g. -!a is -(!a)
+		for(std::size_t i = argument_offset; i > prefix_offset; i--)
+		{
+			parse_tree_node & operator_node = input[i - 1];
+			operator_node.unary_operator_pointer->argument.swap(output);
+			output.swap(operator_node);
+		}
 	}
 }
@@ -0,0 +1,810 @@
+#include <limits>
+#include <vector>
+#include <fridh/optimiser.hpp>
+#include <fridh/resolver.hpp>
+
+namespace fridh
+{
+	namespace
+	{
+		//the type of expressions whose result can't be determined ahead of time
+		variable_type const unknown_type = variable_type_identifier::undefined;
+
+		bool is_constant(parse_tree_node const & node)
+		{
+			return node.type == parse_tree_node_type::variable;
+		}
+
+		bool is_integer_type(variable_type type)
+		{
+			return type == variable_type_identifier::signed_integer || type == variable_type_identifier::unsigned_integer;
+		}
+
+		bool is_numeric_type(variable_type type)
+		{
+			return is_integer_type(type) || type == variable_type_identifier::floating_point_value;
+		}
+
+		bool is_assignment(binary_operator_type::type type)
+		{
+			return type >= binary_operator_type::assignment && type <= binary_operator_type::exponentiation_assignment;
+		}
+
+		bool has_value(variable const & constant, types::signed_integer value)
+		{
+			switch(constant.get_type())
+			{
+				case variable_type_identifier::signed_integer:
+					return constant.get_signed_integer() == value;
+
+				case variable_type_identifier::unsigned_integer:
+					return constant.get_unsigned_integer() == static_cast<types::unsigned_integer>(value);
+
+				case variable_type_identifier::floating_point_value:
+					return constant.get_floating_point_value() == static_cast<types::floating_point_value>(value);
+
+				default:
+					return false;
+			}
+		}
+
+		//replaces a node with one of its own arguments
+		void replace_node(parse_tree_node & node, parse_tree_node & argument)
+		{
+			parse_tree_node replacement;
+			replacement.swap(argument);
+			node.swap(replacement);
+		}
+
+		//mirrors the type rules of the operators of the variable class, anything which would throw yields the unknown type
+		variable_type get_arithmetic_type(variable_type left, variable_type right)
+		{
+			if(!is_numeric_type(left) || !is_numeric_type(right))
+				return unknown_type;
+			else if(left == variable_type_identifier::floating_point_value || right == variable_type_identifier::floating_point_value)
+				return variable_type_identifier::floating_point_value;
+			else if(left == variable_type_identifier::unsigned_integer && right == variable_type_identifier::unsigned_integer)
+				return variable_type_identifier::unsigned_integer;
+			else
+				return variable_type_identifier::signed_integer;
+		}
+
+		variable_type get_binary_operator_type(binary_operator_type::type type, variable_type left, variable_type right)
+		{
+			switch(type)
+			{
+				case binary_operator_type::addition:
+				case binary_operator_type::addition_assignment:
+					if(left == variable_type_identifier::array || right == variable_type_identifier::array)
+						return variable_type_identifier::array;
+					else if(left == unknown_type || right == unknown_type)
+						return unknown_type;
+					else if(left == variable_type_identifier::string || right == variable_type_identifier::string)
+						return variable_type_identifier::string;
+					return get_arithmetic_type(left, right);
+
+				case binary_operator_type::subtraction:
+				case binary_operator_type::multiplication:
+				case binary_operator_type::division:
+				case binary_operator_type::subtraction_assignment:
+				case binary_operator_type::multiplication_assignment:
+				case binary_operator_type::division_assignment:
+					return get_arithmetic_type(left, right);
+
+				case binary_operator_type::modulo:
+				case binary_operator_type::modulo_assignment:
+					if(left == variable_type_identifier::floating_point_value || right == variable_type_identifier::floating_point_value)
+						return unknown_type;
+					return get_arithmetic_type(left, right);
+
+				case binary_operator_type::less_than:
+				case binary_operator_type::less_than_or_equal:
+				case binary_operator_type::greater_than:
+				case binary_operator_type::greater_than_or_equal:
+				case binary_operator_type::not_equal:
+				case binary_operator_type::equal:
+				case binary_operator_type::logical_and:
+				case binary_operator_type::logical_or:
+					return variable_type_identifier::boolean;
+
+				case binary_operator_type::shift_left:
+				case binary_operator_type::shift_right:
+				case binary_operator_type::binary_and:
+				case binary_operator_type::binary_or:
+				case binary_operator_type::binary_xor:
+					return variable_type_identifier::unsigned_integer;
+
+				case binary_operator_type::assignment:
+					return right;
+
+				default:
+					return unknown_type;
+			}
+		}
+
+		bool evaluate_unary_operator(unary_operator_type::type type, variable const & argument, variable & output)
+		{
+			try
+			{
+				switch(type)
+				{
+					case unary_operator_type::negation:
+						argument.negation(output);
+						return true;
+
+					case unary_operator_type::logical_not:
+						argument.logical_not(output);
+						return true;
+
+					case unary_operator_type::binary_not:
+						argument.binary_not(output);
+						return true;
+
+					default:
+						break;
+				}
+			}
+			catch(ail::exception &)
+			{
+			}
+			return false;
+		}
+
+		bool evaluate_binary_operator(binary_operator_type::type type, variable const & left, variable const & right, variable & output)
+		{
+			//dividing the smallest signed integer by minus one traps rather than throwing so it's left to the run time, too
+			bool is_division = type == binary_operator_type::division || type == binary_operator_type::modulo;
+			if(is_division && is_integer_type(left.get_type()) && is_integer_type(right.get_type()))
+			{
+				if(left.get_signed_integer() == std::numeric_limits<types::signed_integer>::min() && right.get_signed_integer() == -1)
+					return false;
+			}
+
+#define BINARY_OPERATION(type) \
+				case binary_operator_type::type: \
+					left.type(right, output); \
+					return true;
+
+			try
+			{
+				switch(type)
+				{
+					BINARY_OPERATION(addition)
+					BINARY_OPERATION(subtraction)
+					BINARY_OPERATION(multiplication)
+					BINARY_OPERATION(division)
+					BINARY_OPERATION(modulo)
+
+					BINARY_OPERATION(less_than)
+					BINARY_OPERATION(less_than_or_equal)
+					BINARY_OPERATION(greater_than)
+					BINARY_OPERATION(greater_than_or_equal)
+					BINARY_OPERATION(not_equal)
+					BINARY_OPERATION(equal)
+
+					BINARY_OPERATION(logical_and)
+					BINARY_OPERATION(logical_or)
+
+					BINARY_OPERATION(shift_left)
+					BINARY_OPERATION(shift_right)
+
+					BINARY_OPERATION(binary_and)
+					BINARY_OPERATION(binary_or)
+					BINARY_OPERATION(binary_xor)
+
+					default:
+						break;
+				}
+			}
+			catch(ail::exception &)
+			{
+			}
+
+#undef BINARY_OPERATION
+
+			return false;
+		}
+
+		class constant_folder
+		{
+		public:
+			void fold_module(module & target_module)
+			{
+				fold_function(target_module.entry_function);
+				fold_functions(target_module.symbols);
+			}
+
+		private:
+			typedef void (constant_folder::*node_handler)(parse_tree_node & node);
+
+			std::vector<variable_type> local_types;
+			std::vector<bool> assigned_locals;
+			//index of the first top-level statement of the function which assigns to the local
+			std::vector<std::size_t> first_assignments;
+			std::size_t current_unit;
+			bool types_changed;
+
+			void fold_functions(symbol_tree_node & node)
+			{
+				for(node_children::iterator i = node.children.begin(), end = node.children.end(); i != end; i++)
+				{
+					symbol_tree_node & child = *i->second;
+					if(child.type == symbol::function)
+						fold_function(*child.function_pointer);
+					fold_functions(child);
+				}
+			}
+
+			void fold_function(function & target)
+			{
+				executable_units & body = target.body;
+
+				local_types.assign(target.local_count, unknown_type);
+				assigned_locals.assign(target.local_count, false);
+				first_assignments.assign(target.local_count, body.size());
+
+				for(std::size_t i = 0, end = target.arguments.size(); i < end; i++)
+					assigned_locals[i] = true;
+
+				for(std::size_t i = 0, end = body.size(); i < end; i++)
+				{
+					executable_unit & unit = body[i];
+					if(unit.type != executable_unit_type::statement || unit.statement_pointer->type != parse_tree_node_type::binary_operator_node)
+						continue;
+					parse_tree_binary_operator_node & binary_node = *unit.statement_pointer->binary_operator_pointer;
+					if(binary_node.type != binary_operator_type::assignment || binary_node.left_argument.type != parse_tree_node_type::symbol)
+						continue;
+					uword slot = binary_node.left_argument.symbol_pointer->slot;
+					if(slot >= target.arguments.size() && slot < target.local_count && first_assignments[slot] == body.size())
+						first_assignments[slot] = i;
+				}
+
+				//every local only changes its type twice at most so this terminates quickly
+				do
+				{
+					types_changed = false;
+					process_body(body, &constant_folder::infer_types);
+				}
+				while(types_changed);
+
+				process_body(body, &constant_folder::fold_node);
+			}
+
+			void process_body(executable_units & body, node_handler handler)
+			{
+				for(std::size_t i = 0, end = body.size(); i < end; i++)
+				{
+					current_unit = i;
+					process_unit(body[i], handler);
+				}
+			}
+
+			void process_units(executable_units & units, node_handler handler)
+			{
+				for(executable_units::iterator i = units.begin(), end = units.end(); i != end; i++)
+					process_unit(*i, handler);
+			}
+
+			void process_unit(executable_unit & unit, node_handler handler)
+			{
+				switch(unit.type)
+				{
+					case executable_unit_type::statement:
+					case executable_unit_type::return_statement:
+						(this->*handler)(*unit.statement_pointer);
+						break;
+
+					case executable_unit_type::if_statement:
+						(this->*handler)(unit.if_pointer->conditional_term);
+						process_units(unit.if_pointer->body, handler);
+						break;
+
+					case executable_unit_type::if_else_statement:
+						(this->*handler)(unit.if_else_pointer->conditional_term);
+						process_units(unit.if_else_pointer->if_body, handler);
+						process_units(unit.if_else_pointer->else_body, handler);
+						break;
+
+					case executable_unit_type::for_each_statement:
+						(this->*handler)(unit.for_each_pointer->container);
+						process_units(unit.for_each_pointer->body, handler);
+						break;
+
+					case executable_unit_type::for_statement:
+						(this->*handler)(unit.for_pointer->initialisation);
+						(this->*handler)(unit.for_pointer->conditional);
+						(this->*handler)(unit.for_pointer->iteration);
+						process_units(unit.for_pointer->body, handler);
+						break;
+
+					case executable_unit_type::while_statement:
+						(this->*handler)(unit.while_pointer->conditional_term);
+						process_units(unit.while_pointer->body, handler);
+						break;
+
+					default:
+						break;
+				}
+			}
+
+			variable_type get_local_type(parse_tree_node const & node)
+			{
+				if(node.type != parse_tree_node_type::symbol)
+					return unknown_type;
+				//before its first assignment a local may still refer to a function or be undefined
+				uword slot = node.symbol_pointer->slot;
+				if(slot >= local_types.size() || first_assignments[slot] >= current_unit || !assigned_locals[slot])
+					return unknown_type;
+				return local_types[slot];
+			}
+
+			variable_type get_type(parse_tree_node const & node)
+			{
+				switch(node.type)
+				{
+					case parse_tree_node_type::variable:
+						return node.variable_pointer->get_type();
+
+					case parse_tree_node_type::symbol:
+						return get_local_type(node);
+
+					case parse_tree_node_type::unary_operator_node:
+					{
+						parse_tree_unary_operator_node const & unary_node = *node.unary_operator_pointer;
+						switch(unary_node.type)
+						{
+							case unary_operator_type::negation:
+							{
+								variable_type argument_type = get_type(unary_node.argument);
+								if(argument_type == variable_type_identifier::floating_point_value)
+									return argument_type;
+								else if(is_integer_type(argument_type))
+									return variable_type_identifier::signed_integer;
+								return unknown_type;
+							}
+
+							case unary_operator_type::logical_not:
+								return variable_type_identifier::boolean;
+
+							case unary_operator_type::binary_not:
+								return variable_type_identifier::unsigned_integer;
+
+							default:
+								//post-fix operators return the previous value
+								return get_type(unary_node.argument);
+						}
+					}
+
+					case parse_tree_node_type::binary_operator_node:
+					{
+						parse_tree_binary_operator_node const & binary_node = *node.binary_operator_pointer;
+						return get_binary_operator_type(binary_node.type, get_type(binary_node.left_argument), get_type(binary_node.right_argument));
+					}
+
+					case parse_tree_node_type::array:
+						return variable_type_identifier::array;
+
+					default:
+						return unknown_type;
+				}
+			}
+
+			void add_local_type(parse_tree_node const & target, variable_type type)
+			{
+				if(target.type != parse_tree_node_type::symbol)
+					return;
+				uword slot = target.symbol_pointer->slot;
+				if(slot >= local_types.size())
+					return;
+
+				if(!assigned_locals[slot])
+				{
+					assigned_locals[slot] = true;
+					local_types[slot] = type;
+					types_changed = true;
+				}
+				else if(local_types[slot] != type && local_types[slot] != unknown_type)
+				{
+					local_types[slot] = unknown_type;
+					types_changed = true;
+				}
+			}
+
+			void infer_types(parse_tree_node & node)
+			{
+				switch(node.type)
+				{
+					case parse_tree_node_type::unary_operator_node:
+					{
+						parse_tree_unary_operator_node & unary_node = *node.unary_operator_pointer;
+						infer_types(unary_node.argument);
+						if(unary_node.type == unary_operator_type::increment || unary_node.type == unary_operator_type::decrement)
+						{
+							binary_operator_type::type operation = unary_node.type == unary_operator_type::increment ? binary_operator_type::addition : binary_operator_type::subtraction;
+							add_local_type(unary_node.argument, get_binary_operator_type(operation, get_type(unary_node.argument), variable_type_identifier::signed_integer));
+						}
+						break;
+					}
+
+					case parse_tree_node_type::binary_operator_node:
+					{
+						parse_tree_binary_operator_node & binary_node = *node.binary_operator_pointer;
+						infer_types(binary_node.left_argument);
+						infer_types(binary_node.right_argument);
+						if(is_assignment(binary_node.type))
+							add_local_type(binary_node.left_argument, get_type(node));
+						break;
+					}
+
+					case parse_tree_node_type::call:
+					{
+						parse_tree_call & call = *node.call_pointer;
+						infer_types(call.function);
+						for(parse_tree_nodes::iterator i = call.arguments.begin(), end = call.arguments.end(); i != end; i++)
+							infer_types(*i);
+						break;
+					}
+
+					case parse_tree_node_type::array:
+					{
+						parse_tree_nodes & elements = node.array_pointer->elements;
+						for(parse_tree_nodes::iterator i = elements.begin(), end = elements.end(); i != end; i++)
+							infer_types(*i);
+						break;
+					}
+
+					default:
+						break;
+				}
+			}
+
+			void fold_node(parse_tree_node & node)
+			{
+				switch(node.type)
+				{
+					case parse_tree_node_type::unary_operator_node:
+					{
+						parse_tree_unary_operator_node & unary_node = *node.unary_operator_pointer;
+						fold_node(unary_node.argument);
+						variable result;
+						if(is_constant(unary_node.argument) && evaluate_unary_operator(unary_node.type, *unary_node.argument.variable_pointer, result))
+						{
+							result.swap(*unary_node.argument.variable_pointer);
+							replace_node(node, unary_node.argument);
+						}
+						break;
+					}
+
+					case parse_tree_node_type::binary_operator_node:
+					{
+						parse_tree_binary_operator_node & binary_node = *node.binary_operator_pointer;
+						fold_node(binary_node.left_argument);
+						fold_node(binary_node.right_argument);
+						variable result;
+						if(is_constant(binary_node.left_argument) && is_constant(binary_node.right_argument))
+						{
+							if(evaluate_binary_operator(binary_node.type, *binary_node.left_argument.variable_pointer, *binary_node.right_argument.variable_pointer, result))
+							{
+								result.swap(*binary_node.left_argument.variable_pointer);
+								replace_node(node, binary_node.left_argument);
+							}
+						}
+						else
+							remove_identity(node);
+						break;
+					}
+
+					case parse_tree_node_type::call:
+					{
+						parse_tree_call & call = *node.call_pointer;
+						fold_node(call.function);
+						for(parse_tree_nodes::iterator i = call.arguments.begin(), end = call.arguments.end(); i != end; i++)
+							fold_node(*i);
+						break;
+					}
+
+					case parse_tree_node_type::array:
+					{
+						parse_tree_nodes & elements = node.array_pointer->elements;
+						bool is_constant_array = true;
+						for(parse_tree_nodes::iterator i = elements.begin(), end = elements.end(); i != end; i++)
+						{
+							fold_node(*i);
+							if(!is_constant(*i))
+								is_constant_array = false;
+						}
+
+						//the array is shared by the values it's evaluated to until one of them gets modified
+						if(is_constant_array)
+						{
+							variable * constant = new variable;
+							constant->new_array();
+							types::vector & array = constant->get_array();
+							array.resize(elements.size());
+							for(std::size_t i = 0, end = elements.size(); i < end; i++)
+								array[i].swap(*elements[i].variable_pointer);
+							parse_tree_node replacement(constant);
+							node.swap(replacement);
+						}
+						break;
+					}
+
+					default:
+						break;
+				}
+			}
+
+			void remove_identity(parse_tree_node & node)
+			{
+				parse_tree_binary_operator_node & binary_node = *node.binary_operator_pointer;
+
+				types::signed_integer identity;
+				bool is_commutative;
+				switch(binary_node.type)
+				{
+					case binary_operator_type::addition:
+						identity = 0;
+						is_commutative = true;
+						break;
+
+					case binary_operator_type::subtraction:
+						identity = 0;
+						is_commutative = false;
+						break;
+
+					case binary_operator_type::multiplication:
+						identity = 1;
+						is_commutative = true;
+						break;
+
+					case binary_operator_type::division:
+						identity = 1;
+						is_commutative = false;
+						break;
+
+					default:
+						return;
+				}
+
+				parse_tree_node & left = binary_node.left_argument;
+				parse_tree_node & right = binary_node.right_argument;
+				bool constant_is_right = is_constant(right);
+				if(!constant_is_right && !(is_commutative && is_constant(left)))
+					return;
+
+				parse_tree_node & operand = constant_is_right ? left : right;
+				variable const & constant = constant_is_right ? *right.variable_pointer : *left.variable_pointer;
+				if(!has_value(constant, identity))
+					return;
+
+				variable_type operand_type = get_type(operand);
+				if(!is_numeric_type(operand_type))
+					return;
+
+				//the result must have the type of the operand, e.g. an unsigned integer plus a signed zero is a signed integer
+				variable_type result_type = constant_is_right ?
+					get_binary_operator_type(binary_node.type, operand_type, constant.get_type()) :
+					get_binary_operator_type(binary_node.type, constant.get_type(), operand_type);
+				if(result_type != operand_type)
+					return;
+
+				//adding zero turns a negative floating point zero into a positive one
+				if(binary_node.type == binary_operator_type::addition && operand_type == variable_type_identifier::floating_point_value)
+					return;
+
+				replace_node(node, operand);
+			}
+		};
+
+		class dead_code_eliminator
+		{
+		public:
+			void eliminate_module(module & target_module)
+			{
+				eliminate_function(target_module.entry_function);
+				eliminate_functions(target_module.symbols);
+			}
+
+		private:
+			std::size_t argument_count;
+			std::size_t for_each_depth;
+
+			void eliminate_functions(symbol_tree_node & node)
+			{
+				for(node_children::iterator i = node.children.begin(), end = node.children.end(); i != end; i++)
+				{
+					symbol_tree_node & child = *i->second;
+					if(child.type == symbol::function)
+						eliminate_function(*child.function_pointer);
+					eliminate_functions(child);
+				}
+			}
+
+			void eliminate_function(function & target)
+			{
+				argument_count = target.arguments.size();
+				for_each_depth = 0;
+				eliminate_units(target.body);
+			}
+
+			//conditions of other types throw when they are evaluated
+			bool get_constant_condition(parse_tree_node const & node, bool & output)
+			{
+				if(!is_constant(node))
+					return false;
+				variable_type type = node.variable_pointer->get_type();
+				if(type != variable_type_identifier::boolean && !is_integer_type(type))
+					return false;
+				output = node.variable_pointer->get_boolean_value();
+				return true;
+			}
+
+			//expressions which can't fail or have any side effects
+			bool is_pure(parse_tree_node const & node)
+			{
+				switch(node.type)
+				{
+					case parse_tree_node_type::variable:
+						return true;
+
+					//arguments are always defined, other names may not refer to anything yet when they are read
+					case parse_tree_node_type::symbol:
+						return node.symbol_pointer->slot < argument_count;
+
+					case parse_tree_node_type::array:
+					{
+						parse_tree_nodes const & elements = node.array_pointer->elements;
+						for(parse_tree_nodes::const_iterator i = elements.begin(), end = elements.end(); i != end; i++)
+						{
+							if(!is_pure(*i))
+								return false;
+						}
+						return true;
+					}
+
+					default:
+						return false;
+				}
+			}
+
+			//dead code which the bytecode compiler would reject is kept so the module is still rejected
+			bool is_removable(executable_unit const & unit)
+			{
+				std::string error_message;
+				return check_unit(unit, for_each_depth > 0, error_message);
+			}
+
+			bool is_removable(executable_units const & units)
+			{
+				std::string error_message;
+				return check_units(units, for_each_depth > 0, error_message);
+			}
+
+			//returns true if the execution never continues after the units
+			bool eliminate_units(executable_units & units)
+			{
+				executable_units output;
+				bool terminates = false;
+				for(executable_units::iterator i = units.begin(), end = units.end(); i != end; i++)
+				{
+					executable_unit & unit = *i;
+					if(terminates)
+					{
+						if(!is_removable(unit))
+							move_back(output, unit);
+						continue;
+					}
+
+					bool condition;
+					switch(unit.type)
+					{
+						case executable_unit_type::statement:
+							if(is_pure(*unit.statement_pointer))
+								continue;
+							break;
+
+						case executable_unit_type::return_statement:
+							terminates = true;
+							break;
+
+						case executable_unit_type::if_statement:
+						{
+							if_statement & statement = *unit.if_pointer;
+							bool body_terminates = eliminate_units(statement.body);
+							if(get_constant_condition(statement.conditional_term, condition))
+							{
+								if(condition)
+								{
+									terminates = append_units(output, statement.body, body_terminates);
+									continue;
+								}
+								else if(is_removable(statement.body))
+									continue;
+							}
+							break;
+						}
+
+						case executable_unit_type::if_else_statement:
+						{
+							if_else_statement & statement = *unit.if_else_pointer;
+							bool if_terminates = eliminate_units(statement.if_body);
+							bool else_terminates = eliminate_units(statement.else_body);
+							if(get_constant_condition(statement.conditional_term, condition) && is_removable(condition ? statement.else_body : statement.if_body))
+							{
+								if(condition)
+									terminates = append_units(output, statement.if_body, if_terminates);
+								else
+									terminates = append_units(output, statement.else_body, else_terminates);
+								continue;
+							}
+							terminates = if_terminates && else_terminates;
+							break;
+						}
+
+						case executable_unit_type::for_each_statement:
+							for_each_depth++;
+							eliminate_units(unit.for_each_pointer->body);
+							for_each_depth--;
+							break;
+
+						case executable_unit_type::for_statement:
+						{
+							for_statement & statement = *unit.for_pointer;
+							eliminate_units(statement.body);
+							//there is no way to leave an endless loop other than returning
+							terminates = get_constant_condition(statement.conditional, condition) && condition;
+							break;
+						}
+
+						case executable_unit_type::while_statement:
+						{
+							while_statement & statement = *unit.while_pointer;
+							eliminate_units(statement.body);
+							if(get_constant_condition(statement.conditional_term, condition))
+							{
+								if(!condition && is_removable(statement.body))
+									continue;
+								terminates = condition;
+							}
+							break;
+						}
+
+						default:
+							break;
+					}
+					move_back(output, unit);
+				}
+				units.swap(output);
+				return terminates;
+			}
+
+			bool append_units(executable_units & output, executable_units & units, bool terminates)
+			{
+				for(executable_units::iterator i = units.begin(), end = units.end(); i != end; i++)
+					move_back(output, *i);
+				return terminates;
+			}
+		};
+	}
+
+	void fold_constants(module & target_module)
+	{
+		arena_scope scope(target_module.arena);
+		constant_folder folder;
+		folder.fold_module(target_module);
+	}
+
+	void eliminate_dead_code(module & target_module)
+	{
+		arena_scope scope(target_module.arena);
+		dead_code_eliminator eliminator;
+		eliminator.eliminate_module(target_module);
+	}
+
+	void optimise_module(module & target_module)
+	{
+		resolve_module(target_module);
+		fold_constants(target_module);
+		eliminate_dead_code(target_module);
+	}
+}
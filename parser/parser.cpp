@@ -2,52 +2,81 @@
 #include <ail/string.hpp>
 #include <fridh/parser.hpp>
 #include <fridh/lexer.hpp>
+#include <fridh/source.hpp>
+#include <fridh/pipeline.hpp>
+#include <fridh/cache.hpp>
 
 namespace fridh
 {
-	parser::parser():
-		running(false)
+	parser::parser(std::size_t pipeline_threshold):
+		running(false),
+		pipeline_threshold(pipeline_threshold),
+		cache(0),
+		pipeline(0)
 	{
 	}
 
+	void parser::set_cache(module_cache const * new_cache)
+	{
+		cache = new_cache;
+	}
+
 	bool parser::process_module(std::string const & path, std::string const & name, module & output, std::string & error_message)
 	{
-		std::string content;
-		if(!ail::read_file(path, content))
+		//the source is mapped instead of being copied into a string, it only has to outlive the translation
+		source_buffer source;
+		if(!source.load(path))
 		{
 			error_message = "Unable to read file \"" + path + "\"";
 			return false;
 		}
 
-		module module_output;
-		bool success = translate_data(module_output, content, name, error_message);
-		if(!success)
+		output.path = path;
+		if(cache != 0 && cache->load(source.data(), source.size(), output))
+			return true;
+
+		if(!translate_data(output, source.data(), source.size(), name, error_message))
 			return false;
 
+		//failing to update the cache only costs the next process the time it takes to parse the module again
+		if(cache != 0)
+			cache->store(source.data(), source.size(), output);
 		return true;
 	}
 
-	bool parser::name_is_used(std::string const & name)
+	bool parser::process_data(std::string const & data, std::string const & name, module & output, std::string & error_message)
+	{
+		output.path = name;
+		return translate_data(output, data.data(), data.size(), name, error_message);
+	}
+
+	bool parser::process_lines(lines_of_code & input, std::string const & name, symbol_tree_node & symbols, executable_units & body, std::string & error_message)
+	{
+		lines.swap(input);
+		pipeline = 0;
+		return translate_lines(symbols, body, name, error_message);
+	}
+
+	bool parser::name_is_used(atom name)
 	{
 		return current_node->exists(name);
 	}
 
-	std::string const & parser::get_declaration_name()
+	atom parser::get_declaration_name()
 	{
-		return *lines[line_offset].lexemes[1].string;
+		return lines[line_offset].lexemes[1].name;
 	}
 
 	void parser::name_collision_check()
 	{
-		std::string const & name = get_declaration_name();
+		atom name = get_declaration_name();
 		if(name_is_used(name))
-			error("Name \"" + name + "\" has already been used by another function or class in the current scope");
+			error("Name \"" + get_atom_string(name) + "\" has already been used by another function or class in the current scope");
 	}
 
 	symbol_tree_node & parser::add_name(symbol::type symbol_type)
 	{
-		std::string const & name = get_declaration_name();
-		symbol_tree_node * & new_node_pointer = current_node->children[name];
+		symbol_tree_node * & new_node_pointer = current_node->children[get_declaration_name()];
 		new_node_pointer = new symbol_tree_node(symbol_type);
 		symbol_tree_node & new_node = *new_node_pointer;
 		new_node.parent = current_node;
@@ -72,7 +101,7 @@ namespace fridh
 			nested_class_level++;
 		}
 
-		while(line_offset < line_end)
+		while(has_line(line_offset))
 		{
 			bool end;
 			if(is_class)
@@ -81,14 +110,19 @@ namespace fridh
 			{
 				executable_unit new_unit;
 				end = process_line(&new_unit, is_anonymous_function);
-				output->push_back(new_unit);
+				//nested function and class declarations do not produce any executable units
+				if(new_unit.type != executable_unit_type::uninitialised)
+					move_back(*output, new_unit);
 			}
 			if(end)
 			{
-				if(indentation_level == 0 && line_offset != line_end - 1)
-					error("Internal error: Invalid indentation level calculated");
-
-				indentation_level--;
+				if(indentation_level == 0)
+				{
+					if(has_line(line_offset))
+						error("Internal error: Invalid indentation level calculated");
+				}
+				else
+					indentation_level--;
 
 				if(is_class)
 					nested_class_level--;
@@ -98,6 +132,13 @@ namespace fridh
 		}
 	}
 
+	void parser::process_nested_body(executable_units & output)
+	{
+		//the line containing the head of the control flow statement has already been processed at this point
+		indentation_level++;
+		process_body(&output, false);
+	}
+
 	bool parser::process_class()
 	{
 		lexeme_container & lexemes = get_lexemes();
@@ -131,7 +172,7 @@ namespace fridh
 			current_function = add_name(symbol::function).function_pointer;
 
 		for(std::size_t i = 2, end = lexemes.size(); i < end; i++)
-			current_function->arguments.push_back(*lexemes[i].string);
+			current_function->arguments.push_back(lexemes[i].name);
 
 		process_body(&current_function->body);
 
@@ -145,7 +186,7 @@ namespace fridh
 		lexeme_container & lexemes = get_lexemes();
 		parse_tree_nodes nodes;
 		process_atomic_statement(lexemes, offset, nodes);
-		output = nodes[0];
+		output.swap(nodes[0]);
 
 		line_offset++;
 	}
@@ -158,7 +199,6 @@ namespace fridh
 	bool parser::process_line(executable_unit * output, bool is_anonymous_function)
 	{
 		line_of_code & current_line = lines[line_offset];
-		std::cout << "Line " << current_line.line << ": " << current_line.indentation_level << std::endl;
 
 		if(current_line.indentation_level > indentation_level)
 			error("Unexpected increase in the indentation level (" + ail::number_to_string(indentation_level) + " to " + ail::number_to_string(current_line.indentation_level) + ")");
@@ -178,7 +218,7 @@ namespace fridh
 				error("Regular statements need to be placed within functions");
 		}
 
-		if(line_offset == line_end)
+		if(!has_line(line_offset))
 		{
 			//end of file -> end of the module entry function block
 			return true;
@@ -190,23 +230,46 @@ namespace fridh
 		return next_line.indentation_level < indentation_level;
 	}
 
-	bool parser::translate_data(module & target_module, std::string const & data, std::string const & module_name, std::string & error_message_output)
+	bool parser::translate_data(module & target_module, char const * data, std::size_t size, std::string const & module_name, std::string & error_message_output)
 	{
-		try
-		{
-			lines = lines_of_code();
-			lexer current_lexer(data, lines);
+		//all the nodes and units of the module are allocated from its arena
+		arena_scope scope(target_module.arena);
+
+		lines = lines_of_code();
+		pipeline = 0;
 
+		if(size < pipeline_threshold)
+		{
+			//the names and strings of the lines reference the data which is only used within this call
+			lexer current_lexer(data, size, lines, true);
 			if(!current_lexer.parse(error_message_output))
 				return false;
 
-			current_node = &target_module.symbols;
+			return translate_lines(target_module.symbols, target_module.entry_function.body, module_name, error_message_output);
+		}
+
+		lexer_pipeline current_pipeline(data, size);
+		pipeline = &current_pipeline;
+		bool success = translate_lines(target_module.symbols, target_module.entry_function.body, module_name, error_message_output);
+		pipeline = 0;
+
+		//errors of the lexer take precedence over those of the parser, just like without the pipeline
+		if(!current_pipeline.finish(error_message_output))
+			return false;
+
+		return success;
+	}
+
+	bool parser::translate_lines(symbol_tree_node & symbols, executable_units & body, std::string const & module_name, std::string & error_message_output)
+	{
+		try
+		{
+			current_node = &symbols;
 			indentation_level = 0;
 			nested_class_level = 0;
 			line_offset = 0;
-			line_end = lines.size();
 
-			process_body(&target_module.entry_function.body, false);
+			process_body(&body, false);
 
 			return true;
 		}
@@ -217,6 +280,17 @@ namespace fridh
 		}
 	}
 
+	bool parser::has_line(std::size_t offset)
+	{
+		//with a pipeline the lines are pulled from the lexer thread on demand
+		while(offset >= lines.size())
+		{
+			if(pipeline == 0 || !pipeline->pull(lines))
+				return false;
+		}
+		return true;
+	}
+
 	lexeme_container & parser::get_lexemes()
 	{
 		return lines[line_offset].lexemes;
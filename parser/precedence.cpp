@@ -1,4 +1,5 @@
-#include <map>
+#include <ail/array.hpp>
+#include <boost/static_assert.hpp>
 #include <fridh/parser.hpp>
 #include <fridh/symbol.hpp>
 
@@ -6,106 +7,76 @@ namespace fridh
 {
 	namespace
 	{
-		std::set<binary_operator_type::type> binary_right_to_left_operators;
+		//the tables are indexed by the operator types and must list them in the order of their declaration
 
-		bool initialised_data = false;
-	}
-
-	void initialise_data()
-	{
-		if(initialised_data)
-			return;
+		word const unary_operator_precedence[] =
+		{
+			//negation, logical_not, binary_not
+			3, 3, 3,
+			//increment, decrement
+			2, 2
+		};
 
+		word const binary_operator_precedence[] =
 		{
-			using namespace binary_operator_type;
-			for(int i = static_cast<int>(assignment); i <= static_cast<int>(exponentiation_assignment); i++)
-				binary_right_to_left_operators.insert(static_cast<binary_operator_type::type>(i));
-		}
+			//addition, subtraction
+			6, 6,
+			//multiplication, division, modulo
+			5, 5, 5,
+			//exponentiation, improvised, not from the C++ operators article as such
+			4,
 
-		initialised_data = true;
-	}
+			//less_than, less_than_or_equal, greater_than, greater_than_or_equal
+			8, 8, 8, 8,
+			//not_equal, equal
+			9, 9,
 
-	word get_unary_operator_precedence(unary_operator_type::type input)
-	{
-		using namespace unary_operator_type;
+			//logical_and, logical_or
+			13, 14,
+
+			//shift_left, shift_right
+			7, 7,
+
+			//binary_and, binary_or, binary_xor
+			10, 12, 11,
+
+			//selection
+			2,
 
-		switch(input)
+			//assignment and the compound assignments
+			16, 16, 16, 16, 16, 16, 16
+		};
+
+		bool const binary_operator_is_right_to_left[] =
 		{
-			case negation:
-			case logical_not:
-			case binary_not:
-				return 3;
-
-			case increment:
-			case decrement:
-				return 2;
-		}
+			false, false, false, false, false, false,
+			false, false, false, false, false, false,
+			false, false,
+			false, false,
+			false, false, false,
+			false,
+			true, true, true, true, true, true, true
+		};
+
+		BOOST_STATIC_ASSERT(sizeof(unary_operator_precedence) / sizeof(unary_operator_precedence[0]) == unary_operator_type::decrement + 1);
+		BOOST_STATIC_ASSERT(sizeof(binary_operator_precedence) / sizeof(binary_operator_precedence[0]) == binary_operator_type::exponentiation_assignment + 1);
+		BOOST_STATIC_ASSERT(sizeof(binary_operator_is_right_to_left) / sizeof(binary_operator_is_right_to_left[0]) == binary_operator_type::exponentiation_assignment + 1);
+	}
 
-		throw ail::exception("Invalid unary operator type");
+	word get_unary_operator_precedence(unary_operator_type::type input)
+	{
+		std::size_t index = static_cast<std::size_t>(input);
+		if(index >= ail::countof(unary_operator_precedence))
+			throw ail::exception("Invalid unary operator type");
+		return unary_operator_precedence[index];
 	}
 
 	word get_binary_operator_precedence(binary_operator_type::type input)
 	{
-		using namespace binary_operator_type;
-
-		switch(input)
-		{
-			case addition:
-			case subtraction:
-				return 6;
-
-			case multiplication:
-			case division:
-			case modulo:
-				return 5;
-
-			case exponentiation:
-				//improvised, not from the C++ operators article as such
-				return 4;
-
-			case less_than:
-			case less_than_or_equal:
-			case greater_than:
-			case greater_than_or_equal:
-				return 8;
-
-			case not_equal:
-			case equal:
-				return 9;
-
-			case logical_and:
-				return 13;
-
-			case logical_or:
-				return 14;
-
-			case shift_left:
-			case shift_right:
-				return 7;
-
-			case binary_and:
-				return 10;
-
-			case binary_or:
-				return 12;
-
-			case binary_xor:
-				return 11;
-
-			case selection:
-				return 2;
-
-			case assignment:
-			case addition_assignment:
-			case subtraction_assignment:
-			case multiplication_assignment:
-			case division_assignment:
-			case modulo_assignment:
-			case exponentiation_assignment:
-				return 16;
-		}
-
-		throw ail::exception("Invalid binary operator type");
+		std::size_t index = static_cast<std::size_t>(input);
+		if(index >= ail::countof(binary_operator_precedence))
+			throw ail::exception("Invalid binary operator type");
+		return binary_operator_precedence[index];
 	}
 
 	bool get_parse_tree_node_precedence(parse_tree_node & input, word & output)
@@ -134,15 +105,13 @@ namespace fridh
 
 	bool is_right_to_left_operator(parse_tree_node & input)
 	{
-		initialise_data();
-
 		if(input.type == parse_tree_node_type::unary_operator_node)
 			return true;
 
 		if
 		(
 			input.type == parse_tree_node_type::binary_operator_node &&
-			binary_right_to_left_operators.find(input.binary_operator_pointer->type) != binary_right_to_left_operators.end()
+			binary_operator_is_right_to_left[input.binary_operator_pointer->type]
 		)
 				return true;
 
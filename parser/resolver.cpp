@@ -0,0 +1,436 @@
+#include <map>
+#include <ail/string.hpp>
+#include <fridh/resolver.hpp>
+
+namespace fridh
+{
+	namespace
+	{
+		class symbol_resolver
+		{
+		public:
+			void resolve_module(module & target_module)
+			{
+				resolve_function(target_module.entry_function, target_module.symbols);
+				resolve_functions(target_module.symbols);
+			}
+
+		private:
+			typedef std::map<atom, uword> slot_map;
+
+			symbol_tree_node * scope;
+			slot_map slots;
+			uword slot_count;
+
+			void resolve_functions(symbol_tree_node & node)
+			{
+				for(node_children::iterator i = node.children.begin(), end = node.children.end(); i != end; i++)
+				{
+					symbol_tree_node & child = *i->second;
+					if(child.type == symbol::function)
+						resolve_function(*child.function_pointer, child);
+					resolve_functions(child);
+				}
+			}
+
+			void resolve_function(function & target, symbol_tree_node & function_scope)
+			{
+				scope = &function_scope;
+				slots.clear();
+
+				//every argument gets its own slot, a repeated name refers to the last one
+				for(std::size_t i = 0, end = target.arguments.size(); i < end; i++)
+					slots[target.arguments[i]] = i;
+				slot_count = target.arguments.size();
+
+				//all assignments are collected first because a variable may be read before the assignment which declares it
+				collect_locals(target.body);
+				target.local_count = slot_count;
+
+				resolve_units(target.body);
+			}
+
+			void add_local(atom name)
+			{
+				if(slots.find(name) == slots.end())
+				{
+					slots[name] = slot_count;
+					slot_count++;
+				}
+			}
+
+			void collect_locals(executable_units & units)
+			{
+				for(executable_units::iterator i = units.begin(), end = units.end(); i != end; i++)
+				{
+					executable_unit & unit = *i;
+					switch(unit.type)
+					{
+						case executable_unit_type::statement:
+						case executable_unit_type::return_statement:
+							collect_locals(*unit.statement_pointer);
+							break;
+
+						case executable_unit_type::if_statement:
+							collect_locals(unit.if_pointer->conditional_term);
+							collect_locals(unit.if_pointer->body);
+							break;
+
+						case executable_unit_type::if_else_statement:
+							collect_locals(unit.if_else_pointer->conditional_term);
+							collect_locals(unit.if_else_pointer->if_body);
+							collect_locals(unit.if_else_pointer->else_body);
+							break;
+
+						case executable_unit_type::for_each_statement:
+							collect_locals(unit.for_each_pointer->container);
+							collect_locals(unit.for_each_pointer->body);
+							break;
+
+						case executable_unit_type::for_statement:
+							collect_locals(unit.for_pointer->initialisation);
+							collect_locals(unit.for_pointer->conditional);
+							collect_locals(unit.for_pointer->iteration);
+							collect_locals(unit.for_pointer->body);
+							break;
+
+						case executable_unit_type::while_statement:
+							collect_locals(unit.while_pointer->conditional_term);
+							collect_locals(unit.while_pointer->body);
+							break;
+
+						default:
+							throw ail::exception("Encountered an uninitialised executable unit");
+					}
+				}
+			}
+
+			void collect_locals(parse_tree_node & node)
+			{
+				switch(node.type)
+				{
+					case parse_tree_node_type::unary_operator_node:
+					{
+						parse_tree_unary_operator_node & unary_node = *node.unary_operator_pointer;
+						bool is_assignment =
+							unary_node.type == unary_operator_type::increment ||
+							unary_node.type == unary_operator_type::decrement;
+						if(is_assignment && unary_node.argument.type == parse_tree_node_type::symbol)
+							add_local(unary_node.argument.symbol_pointer->name);
+						collect_locals(unary_node.argument);
+						break;
+					}
+
+					case parse_tree_node_type::binary_operator_node:
+					{
+						parse_tree_binary_operator_node & binary_node = *node.binary_operator_pointer;
+						bool is_assignment =
+							binary_node.type >= binary_operator_type::assignment &&
+							binary_node.type <= binary_operator_type::exponentiation_assignment;
+						if(is_assignment && binary_node.left_argument.type == parse_tree_node_type::symbol)
+							add_local(binary_node.left_argument.symbol_pointer->name);
+						collect_locals(binary_node.left_argument);
+						collect_locals(binary_node.right_argument);
+						break;
+					}
+
+					case parse_tree_node_type::call:
+					{
+						parse_tree_call & call = *node.call_pointer;
+						collect_locals(call.function);
+						for(parse_tree_nodes::iterator i = call.arguments.begin(), end = call.arguments.end(); i != end; i++)
+							collect_locals(*i);
+						break;
+					}
+
+					case parse_tree_node_type::array:
+					{
+						parse_tree_nodes & elements = node.array_pointer->elements;
+						for(parse_tree_nodes::iterator i = elements.begin(), end = elements.end(); i != end; i++)
+							collect_locals(*i);
+						break;
+					}
+
+					default:
+						break;
+				}
+			}
+
+			void resolve_units(executable_units & units)
+			{
+				for(executable_units::iterator i = units.begin(), end = units.end(); i != end; i++)
+				{
+					executable_unit & unit = *i;
+					switch(unit.type)
+					{
+						case executable_unit_type::statement:
+						case executable_unit_type::return_statement:
+							resolve_node(*unit.statement_pointer);
+							break;
+
+						case executable_unit_type::if_statement:
+							resolve_node(unit.if_pointer->conditional_term);
+							resolve_units(unit.if_pointer->body);
+							break;
+
+						case executable_unit_type::if_else_statement:
+							resolve_node(unit.if_else_pointer->conditional_term);
+							resolve_units(unit.if_else_pointer->if_body);
+							resolve_units(unit.if_else_pointer->else_body);
+							break;
+
+						case executable_unit_type::for_each_statement:
+							resolve_node(unit.for_each_pointer->container);
+							resolve_units(unit.for_each_pointer->body);
+							break;
+
+						case executable_unit_type::for_statement:
+							resolve_node(unit.for_pointer->initialisation);
+							resolve_node(unit.for_pointer->conditional);
+							resolve_node(unit.for_pointer->iteration);
+							resolve_units(unit.for_pointer->body);
+							break;
+
+						case executable_unit_type::while_statement:
+							resolve_node(unit.while_pointer->conditional_term);
+							resolve_units(unit.while_pointer->body);
+							break;
+
+						default:
+							throw ail::exception("Encountered an uninitialised executable unit");
+					}
+				}
+			}
+
+			void resolve_node(parse_tree_node & node)
+			{
+				switch(node.type)
+				{
+					case parse_tree_node_type::symbol:
+						resolve_symbol(*node.symbol_pointer);
+						break;
+
+					case parse_tree_node_type::unary_operator_node:
+						resolve_node(node.unary_operator_pointer->argument);
+						break;
+
+					case parse_tree_node_type::binary_operator_node:
+						resolve_node(node.binary_operator_pointer->left_argument);
+						resolve_node(node.binary_operator_pointer->right_argument);
+						break;
+
+					case parse_tree_node_type::call:
+					{
+						parse_tree_call & call = *node.call_pointer;
+						resolve_node(call.function);
+						for(parse_tree_nodes::iterator i = call.arguments.begin(), end = call.arguments.end(); i != end; i++)
+							resolve_node(*i);
+						break;
+					}
+
+					case parse_tree_node_type::array:
+					{
+						parse_tree_nodes & elements = node.array_pointer->elements;
+						for(parse_tree_nodes::iterator i = elements.begin(), end = elements.end(); i != end; i++)
+							resolve_node(*i);
+						break;
+					}
+
+					default:
+						break;
+				}
+			}
+
+			//a local variable may shadow a function so both are recorded, the function is used as long as the variable hasn't been assigned
+			void resolve_symbol(parse_tree_symbol & symbol)
+			{
+				slot_map::iterator iterator = slots.find(symbol.name);
+				symbol.slot = iterator == slots.end() ? parse_tree_symbol::no_slot : iterator->second;
+
+				symbol_tree_node * node;
+				if(scope->find_entity(symbol.name, node) && node->type == symbol::function)
+					symbol.function_node = node;
+				else
+					symbol.function_node = 0;
+			}
+		};
+
+		class static_checker
+		{
+		public:
+			static_checker(bool in_for_each, std::string & error_message):
+				for_each_depth(in_for_each ? 1 : 0),
+				error_message(error_message)
+			{
+			}
+
+			bool check_units(executable_units const & units)
+			{
+				for(executable_units::const_iterator i = units.begin(), end = units.end(); i != end; i++)
+				{
+					if(!check_unit(*i))
+						return false;
+				}
+				return true;
+			}
+
+			bool check_unit(executable_unit const & unit)
+			{
+				switch(unit.type)
+				{
+					case executable_unit_type::statement:
+					case executable_unit_type::return_statement:
+						return check_node(*unit.statement_pointer);
+
+					case executable_unit_type::if_statement:
+						return check_node(unit.if_pointer->conditional_term) && check_units(unit.if_pointer->body);
+
+					case executable_unit_type::if_else_statement:
+						return check_node(unit.if_else_pointer->conditional_term) && check_units(unit.if_else_pointer->if_body) && check_units(unit.if_else_pointer->else_body);
+
+					case executable_unit_type::for_each_statement:
+					{
+						if(!check_node(unit.for_each_pointer->container))
+							return false;
+						for_each_depth++;
+						bool output = check_units(unit.for_each_pointer->body);
+						for_each_depth--;
+						return output;
+					}
+
+					case executable_unit_type::for_statement:
+						return check_node(unit.for_pointer->initialisation) && check_node(unit.for_pointer->conditional) && check_node(unit.for_pointer->iteration) && check_units(unit.for_pointer->body);
+
+					case executable_unit_type::while_statement:
+						return check_node(unit.while_pointer->conditional_term) && check_units(unit.while_pointer->body);
+
+					default:
+						return fail("Encountered an uninitialised executable unit");
+				}
+			}
+
+		private:
+			uword for_each_depth;
+			std::string & error_message;
+
+			bool fail(std::string const & message)
+			{
+				error_message = message;
+				return false;
+			}
+
+			bool check_target(parse_tree_node const & node)
+			{
+				if(node.type != parse_tree_node_type::symbol)
+					return fail("Assignments are only supported for symbols at this point");
+				return true;
+			}
+
+			bool check_nodes(parse_tree_nodes const & nodes)
+			{
+				for(parse_tree_nodes::const_iterator i = nodes.begin(), end = nodes.end(); i != end; i++)
+				{
+					if(!check_node(*i))
+						return false;
+				}
+				return true;
+			}
+
+			bool check_node(parse_tree_node const & node)
+			{
+				switch(node.type)
+				{
+					case parse_tree_node_type::variable:
+						return true;
+
+					case parse_tree_node_type::symbol:
+					{
+						parse_tree_symbol const & symbol = *node.symbol_pointer;
+						if(symbol.slot == parse_tree_symbol::no_slot && symbol.function_node == 0)
+							return fail("Unknown symbol \"" + get_atom_string(symbol.name) + "\"");
+						return true;
+					}
+
+					case parse_tree_node_type::unary_operator_node:
+					{
+						parse_tree_unary_operator_node const & unary_node = *node.unary_operator_pointer;
+						if(unary_node.type == unary_operator_type::increment || unary_node.type == unary_operator_type::decrement)
+							return check_target(unary_node.argument);
+						return check_node(unary_node.argument);
+					}
+
+					case parse_tree_node_type::binary_operator_node:
+					{
+						parse_tree_binary_operator_node const & binary_node = *node.binary_operator_pointer;
+						switch(binary_node.type)
+						{
+							case binary_operator_type::exponentiation:
+								return fail("Exponentiation has not been implemented yet");
+
+							case binary_operator_type::exponentiation_assignment:
+								return check_target(binary_node.left_argument) && fail("Exponentiation has not been implemented yet");
+
+							case binary_operator_type::selection:
+								return fail("Selection has not been implemented yet");
+
+							default:
+								break;
+						}
+
+						bool is_assignment = binary_node.type >= binary_operator_type::assignment && binary_node.type <= binary_operator_type::exponentiation_assignment;
+						if(is_assignment)
+							return check_target(binary_node.left_argument) && check_node(binary_node.right_argument);
+						return check_node(binary_node.left_argument) && check_node(binary_node.right_argument);
+					}
+
+					case parse_tree_node_type::call:
+					{
+						parse_tree_call const & call = *node.call_pointer;
+						if(call.function.type == parse_tree_node_type::symbol)
+						{
+							//calls to functions which are known ahead of time must match their number of arguments
+							parse_tree_symbol const & symbol = *call.function.symbol_pointer;
+							symbol_tree_node * function_node = symbol.function_node;
+							if(symbol.slot == parse_tree_symbol::no_slot && function_node != 0)
+							{
+								std::size_t expected_argument_count = function_node->function_pointer->arguments.size();
+								if(call.arguments.size() != expected_argument_count)
+									return fail("Invalid argument count in call to \"" + get_atom_string(symbol.name) + "\": expected " + ail::number_to_string(expected_argument_count) + ", got " + ail::number_to_string(call.arguments.size()));
+							}
+						}
+						return check_node(call.function) && check_nodes(call.arguments);
+					}
+
+					case parse_tree_node_type::array:
+						return check_nodes(node.array_pointer->elements);
+
+					case parse_tree_node_type::iterator:
+						if(for_each_depth == 0)
+							return fail("Encountered an iterator outside of a for each statement");
+						return true;
+
+					default:
+						return fail("Unable to compile parse tree node of type " + node.to_string());
+				}
+			}
+		};
+	}
+
+	void resolve_module(module & target_module)
+	{
+		symbol_resolver resolver;
+		resolver.resolve_module(target_module);
+	}
+
+	bool check_units(executable_units const & units, bool in_for_each, std::string & error_message)
+	{
+		static_checker checker(in_for_each, error_message);
+		return checker.check_units(units);
+	}
+
+	bool check_unit(executable_unit const & unit, bool in_for_each, std::string & error_message)
+	{
+		static_checker checker(in_for_each, error_message);
+		return checker.check_unit(unit);
+	}
+}
@@ -15,20 +15,13 @@ namespace fridh
 	{
 		parse_tree_node unary_operator_node;
 		lexeme_to_unary_operator_node(current_lexeme, unary_operator_node);
-		arguments.push_back(unary_operator_node);
+		move_back(arguments, unary_operator_node);
 	}
 
 	void add_negation_lexeme(parse_tree_nodes & arguments)
 	{
-		add_unary_node(lexeme(lexeme_type::negation), arguments);
-	}
-
-	void visualise_nodes(parse_tree_nodes & nodes)
-	{
-		std::cout << "Parse tree nodes:" << std::endl;
-		uword counter = 1;
-		for(parse_tree_nodes::iterator i = nodes.begin(), end = nodes.end(); i != end; i++, counter++)
-			std::cout << counter << ". " << i->to_string() << std::endl;
+		lexeme negation_lexeme(lexeme_type::negation);
+		add_unary_node(negation_lexeme, arguments);
 	}
 
 	void parser::process_node_group(parse_tree_nodes & arguments, parse_tree_nodes & output)
@@ -37,7 +30,7 @@ namespace fridh
 		{
 			parse_tree_node new_node;
 			operator_resolution(arguments, new_node);
-			output.push_back(new_node);
+			move_back(output, new_node);
 		}
 	}
 
@@ -80,13 +73,13 @@ namespace fridh
 						process_atomic_statement(lexemes, offset, content, true, lexeme_type::bracket_end);
 						parse_tree_node call;
 						call.is_call();
-						call.call_pointer->arguments = content;
-						arguments.push_back(call);
+						call.call_pointer->arguments.swap(content);
+						move_back(arguments, call);
 					}
 					else
 					{
 						process_atomic_statement(lexemes, offset, content, false, lexeme_type::bracket_end, true);
-						arguments.push_back(content[0]);
+						move_back(arguments, content[0]);
 					}
 					set_last_group(lexeme_group::argument, last_group, got_last_group);
 					continue;
@@ -165,7 +158,7 @@ namespace fridh
 							prefix = symbol_prefix::none;
 						}
 					}
-					arguments.push_back(argument_node);
+					move_back(arguments, argument_node);
 					break;
 				}
 
@@ -185,11 +178,10 @@ namespace fridh
 								double_lexeme_error("Encountered a unary operator followed by a binary operator", i);
 
 							case lexeme_group::binary_operator:
-								if(current_lexeme.type == lexeme_type::subtraction)
-									add_negation_lexeme(arguments);
-								else
+								if(current_lexeme.type != lexeme_type::subtraction)
 									double_lexeme_error("Encountered two sequential binary operators", i);
-								break;
+								add_negation_lexeme(arguments);
+								continue;
 						}
 					}
 					else
@@ -203,7 +195,7 @@ namespace fridh
 
 					parse_tree_node binary_operator_node;
 					lexeme_to_binary_operator_node(current_lexeme, binary_operator_node);
-					arguments.push_back(binary_operator_node);
+					move_back(arguments, binary_operator_node);
 					break;
 				}
 
@@ -0,0 +1,803 @@
+#include <cstring>
+#include <map>
+#include <ail/exception.hpp>
+#include <ail/string.hpp>
+#include <fridh/flat.hpp>
+
+namespace fridh
+{
+	namespace
+	{
+		//the atom table never hands out this value
+		atom const no_atom = 0xffffffff;
+
+		void invalid_flat_module_error()
+		{
+			throw ail::exception("The flat module is invalid");
+		}
+
+		class module_flattener
+		{
+		public:
+			module_flattener(flat_module & output):
+				output(output)
+			{
+			}
+
+			void flatten(module const & input)
+			{
+				output.clear();
+
+				output.functions.resize(1);
+				flatten_function(input.entry_function, 0);
+
+				output.symbol_tree_nodes.resize(1);
+				flatten_symbol_tree_node(input.symbols, 0, add_string(""));
+			}
+
+		private:
+			flat_module & output;
+			std::map<std::string, flat_index> string_indices;
+
+			template<typename type>
+			flat_range reserve(std::vector<type> & container, std::size_t count)
+			{
+				if(count > 0xffffffff - container.size())
+					throw ail::exception("The module is too big to be flattened");
+
+				flat_range output;
+				output.offset = static_cast<flat_index>(container.size());
+				output.size = static_cast<flat_index>(count);
+				container.resize(container.size() + count);
+				return output;
+			}
+
+			template<typename type>
+			flat_index append(std::vector<type> & container)
+			{
+				return reserve(container, 1).offset;
+			}
+
+			flat_index add_string(std::string const & input)
+			{
+				std::map<std::string, flat_index>::iterator iterator = string_indices.find(input);
+				if(iterator != string_indices.end())
+					return iterator->second;
+
+				if(input.size() > 0xffffffff - output.characters.size())
+					throw ail::exception("The module is too big to be flattened");
+
+				flat_index index = append(output.strings);
+				flat_range & range = output.strings[index];
+				range.offset = static_cast<flat_index>(output.characters.size());
+				range.size = static_cast<flat_index>(input.size());
+				output.characters += input;
+				string_indices[input] = index;
+				return index;
+			}
+
+			flat_index add_constant(variable const & input)
+			{
+				flat_index index = append(output.constants);
+				flat_constant constant;
+				std::memset(&constant, 0, sizeof(constant));
+				variable_type type = input.get_type();
+				constant.type = type;
+				switch(type)
+				{
+					case variable_type_identifier::undefined:
+					case variable_type_identifier::nil:
+					case variable_type_identifier::none:
+						break;
+
+					case variable_type_identifier::boolean:
+						constant.unsigned_integer = input.get_boolean() ? 1 : 0;
+						break;
+
+					case variable_type_identifier::signed_integer:
+						constant.signed_integer = static_cast<boost::int64_t>(input.get_signed_integer());
+						break;
+
+					case variable_type_identifier::unsigned_integer:
+						constant.unsigned_integer = static_cast<boost::uint64_t>(input.get_unsigned_integer());
+						break;
+
+					case variable_type_identifier::floating_point_value:
+						constant.floating_point_value = input.get_floating_point_value();
+						break;
+
+					case variable_type_identifier::string:
+						constant.unsigned_integer = add_string(input.get_string());
+						break;
+
+					default:
+						throw ail::exception("Variables of type " + get_type_string(type) + " can't be flattened");
+				}
+				output.constants[index] = constant;
+				return index;
+			}
+
+			void flatten_symbol_tree_node(symbol_tree_node const & input, flat_index slot, flat_index name)
+			{
+				flat_index member = 0;
+				switch(input.type)
+				{
+					case symbol::function:
+						member = append(output.functions);
+						flatten_function(*input.function_pointer, member);
+						break;
+
+					case symbol::class_symbol:
+						member = add_string(input.class_pointer->name);
+						break;
+
+					case symbol::module:
+						throw ail::exception("Nested modules can't be flattened");
+
+					default:
+						break;
+				}
+
+				//the children are reserved before any of them is flattened so they end up next to each other
+				flat_range children = reserve(output.symbol_tree_nodes, input.children.size());
+				flat_index child = children.offset;
+				for(node_children::const_iterator i = input.children.begin(), end = input.children.end(); i != end; i++, child++)
+					flatten_symbol_tree_node(*i->second, child, add_string(get_atom_string(i->first)));
+
+				flat_symbol_tree_node & node = output.symbol_tree_nodes[slot];
+				node.type = input.type;
+				node.name = name;
+				node.member = member;
+				node.children = children;
+			}
+
+			void flatten_function(function const & input, flat_index slot)
+			{
+				flat_range arguments = reserve(output.argument_names, input.arguments.size());
+				for(std::size_t i = 0; i < input.arguments.size(); i++)
+				{
+					flat_index name = add_string(get_atom_string(input.arguments[i]));
+					output.argument_names[arguments.offset + i] = name;
+				}
+
+				flat_range body = flatten_units(input.body);
+
+				flat_function & function_output = output.functions[slot];
+				function_output.arguments = arguments;
+				function_output.body = body;
+			}
+
+			flat_range flatten_units(executable_units const & input)
+			{
+				flat_range units = reserve(output.units, input.size());
+				for(std::size_t i = 0; i < input.size(); i++)
+					flatten_unit(input[i], units.offset + static_cast<flat_index>(i));
+				return units;
+			}
+
+			//the vectors grow while the children are flattened so the elements are only written once they are complete
+			void flatten_unit(executable_unit const & input, flat_index slot)
+			{
+				flat_index index = 0;
+				switch(input.type)
+				{
+					case executable_unit_type::statement:
+					case executable_unit_type::return_statement:
+						index = append(output.nodes);
+						flatten_node(*input.statement_pointer, index);
+						break;
+
+					case executable_unit_type::if_statement:
+					{
+						flat_if_statement statement;
+						index = append(output.if_statements);
+						statement.conditional_term = append(output.nodes);
+						flatten_node(input.if_pointer->conditional_term, statement.conditional_term);
+						statement.body = flatten_units(input.if_pointer->body);
+						output.if_statements[index] = statement;
+						break;
+					}
+
+					case executable_unit_type::if_else_statement:
+					{
+						flat_if_else_statement statement;
+						index = append(output.if_else_statements);
+						statement.conditional_term = append(output.nodes);
+						flatten_node(input.if_else_pointer->conditional_term, statement.conditional_term);
+						statement.if_body = flatten_units(input.if_else_pointer->if_body);
+						statement.else_body = flatten_units(input.if_else_pointer->else_body);
+						output.if_else_statements[index] = statement;
+						break;
+					}
+
+					case executable_unit_type::for_each_statement:
+					{
+						flat_for_each_statement statement;
+						index = append(output.for_each_statements);
+						statement.container = append(output.nodes);
+						flatten_node(input.for_each_pointer->container, statement.container);
+						statement.body = flatten_units(input.for_each_pointer->body);
+						output.for_each_statements[index] = statement;
+						break;
+					}
+
+					case executable_unit_type::for_statement:
+					{
+						flat_for_statement statement;
+						index = append(output.for_statements);
+						flat_range terms = reserve(output.nodes, 3);
+						statement.initialisation = terms.offset;
+						statement.conditional = terms.offset + 1;
+						statement.iteration = terms.offset + 2;
+						flatten_node(input.for_pointer->initialisation, statement.initialisation);
+						flatten_node(input.for_pointer->conditional, statement.conditional);
+						flatten_node(input.for_pointer->iteration, statement.iteration);
+						statement.body = flatten_units(input.for_pointer->body);
+						output.for_statements[index] = statement;
+						break;
+					}
+
+					case executable_unit_type::while_statement:
+					{
+						flat_while_statement statement;
+						index = append(output.while_statements);
+						statement.conditional_term = append(output.nodes);
+						flatten_node(input.while_pointer->conditional_term, statement.conditional_term);
+						statement.body = flatten_units(input.while_pointer->body);
+						output.while_statements[index] = statement;
+						break;
+					}
+
+					default:
+						break;
+				}
+
+				flat_unit & unit = output.units[slot];
+				unit.type = input.type;
+				unit.index = index;
+			}
+
+			void flatten_nodes(parse_tree_nodes const & input, flat_range nodes)
+			{
+				for(std::size_t i = 0; i < input.size(); i++)
+					flatten_node(input[i], nodes.offset + static_cast<flat_index>(i));
+			}
+
+			void flatten_node(parse_tree_node const & input, flat_index slot)
+			{
+				flat_index index = 0;
+				switch(input.type)
+				{
+					case parse_tree_node_type::variable:
+						index = add_constant(*input.variable_pointer);
+						break;
+
+					case parse_tree_node_type::symbol:
+					{
+						flat_symbol symbol;
+						symbol.name = add_string(get_atom_string(input.symbol_pointer->name));
+						symbol.type = input.symbol_pointer->type;
+						index = append(output.symbols);
+						output.symbols[index] = symbol;
+						break;
+					}
+
+					case parse_tree_node_type::unary_operator_node:
+					{
+						flat_unary_operator_node node;
+						index = append(output.unary_operator_nodes);
+						node.type = input.unary_operator_pointer->type;
+						node.argument = append(output.nodes);
+						flatten_node(input.unary_operator_pointer->argument, node.argument);
+						output.unary_operator_nodes[index] = node;
+						break;
+					}
+
+					case parse_tree_node_type::binary_operator_node:
+					{
+						flat_binary_operator_node node;
+						index = append(output.binary_operator_nodes);
+						node.type = input.binary_operator_pointer->type;
+						flat_range arguments = reserve(output.nodes, 2);
+						node.left_argument = arguments.offset;
+						node.right_argument = arguments.offset + 1;
+						flatten_node(input.binary_operator_pointer->left_argument, node.left_argument);
+						flatten_node(input.binary_operator_pointer->right_argument, node.right_argument);
+						output.binary_operator_nodes[index] = node;
+						break;
+					}
+
+					case parse_tree_node_type::call:
+					{
+						flat_call call;
+						index = append(output.calls);
+						call.function = append(output.nodes);
+						call.arguments = reserve(output.nodes, input.call_pointer->arguments.size());
+						flatten_node(input.call_pointer->function, call.function);
+						flatten_nodes(input.call_pointer->arguments, call.arguments);
+						output.calls[index] = call;
+						break;
+					}
+
+					case parse_tree_node_type::array:
+					{
+						index = append(output.arrays);
+						flat_range elements = reserve(output.nodes, input.array_pointer->elements.size());
+						flatten_nodes(input.array_pointer->elements, elements);
+						output.arrays[index] = elements;
+						break;
+					}
+
+					default:
+						break;
+				}
+
+				flat_node & node = output.nodes[slot];
+				node.type = input.type;
+				node.index = index;
+			}
+		};
+
+		class module_expander
+		{
+		public:
+			module_expander(flat_module const & input):
+				input(input),
+				visited_symbol_tree_nodes(input.symbol_tree_nodes.size(), false),
+				visited_functions(input.functions.size(), false),
+				visited_units(input.units.size(), false),
+				visited_nodes(input.nodes.size(), false),
+				atoms(input.strings.size(), no_atom)
+			{
+			}
+
+			void expand(symbol_tree_node & symbols, function & entry_function)
+			{
+				if(input.symbol_tree_nodes.empty() || input.functions.empty())
+					invalid_flat_module_error();
+
+				//the root of the symbol tree of a module never has a type
+				flat_symbol_tree_node const & root = input.symbol_tree_nodes[0];
+				if(root.type != symbol::uninitialised)
+					invalid_flat_module_error();
+				visited_symbol_tree_nodes[0] = true;
+
+				expand_function(0, entry_function);
+				expand_symbol_tree_node(root, symbols);
+			}
+
+		private:
+			flat_module const & input;
+
+			std::vector<bool>
+				visited_symbol_tree_nodes,
+				visited_functions,
+				visited_units,
+				visited_nodes;
+
+			std::vector<atom> atoms;
+
+			template<typename type>
+			type const & get_element(std::vector<type> const & container, flat_index index)
+			{
+				if(index >= container.size())
+					invalid_flat_module_error();
+				return container[index];
+			}
+
+			void check_range(flat_range range, std::size_t size)
+			{
+				if(range.offset > size || range.size > size - range.offset)
+					invalid_flat_module_error();
+			}
+
+			//every element may only be referenced once, otherwise a corrupted module could describe cycles or exponentially large trees
+			void visit(std::vector<bool> & visited, flat_index index)
+			{
+				if(index >= visited.size() || visited[index])
+					invalid_flat_module_error();
+				visited[index] = true;
+			}
+
+			template<typename type>
+			type get_enum(boost::uint32_t input, type last)
+			{
+				if(input > static_cast<boost::uint32_t>(last))
+					invalid_flat_module_error();
+				return static_cast<type>(input);
+			}
+
+			void get_string(flat_index index, std::string & output)
+			{
+				flat_range range = get_element(input.strings, index);
+				check_range(range, input.characters.size());
+				output.assign(input.characters, range.offset, range.size);
+			}
+
+			//every distinct string is only interned once
+			atom get_name(flat_index index)
+			{
+				flat_range range = get_element(input.strings, index);
+				atom & output = atoms[index];
+				if(output == no_atom)
+				{
+					check_range(range, input.characters.size());
+					output = get_atom(input.characters.data() + range.offset, range.size);
+				}
+				return output;
+			}
+
+			void expand_symbol_tree_node(flat_symbol_tree_node const & node, symbol_tree_node & output)
+			{
+				switch(output.type)
+				{
+					case symbol::function:
+						expand_function(node.member, *output.function_pointer);
+						break;
+
+					case symbol::class_symbol:
+						get_string(node.member, output.class_pointer->name);
+						break;
+
+					default:
+						break;
+				}
+
+				check_range(node.children, input.symbol_tree_nodes.size());
+				for(flat_index i = node.children.offset, end = node.children.offset + node.children.size; i < end; i++)
+				{
+					visit(visited_symbol_tree_nodes, i);
+					flat_symbol_tree_node const & child = input.symbol_tree_nodes[i];
+
+					atom name = get_name(child.name);
+					symbol::type type = get_enum(child.type, symbol::class_symbol);
+
+					symbol_tree_node * & child_pointer = output.children[name];
+					if(child_pointer != 0)
+						invalid_flat_module_error();
+					child_pointer = new symbol_tree_node(type);
+					child_pointer->parent = &output;
+					expand_symbol_tree_node(child, *child_pointer);
+				}
+			}
+
+			void expand_function(flat_index index, function & output)
+			{
+				visit(visited_functions, index);
+				flat_function const & function_input = input.functions[index];
+
+				check_range(function_input.arguments, input.argument_names.size());
+				output.arguments.resize(function_input.arguments.size);
+				for(flat_index i = 0; i < function_input.arguments.size; i++)
+					output.arguments[i] = get_name(input.argument_names[function_input.arguments.offset + i]);
+
+				expand_units(function_input.body, output.body);
+			}
+
+			void expand_units(flat_range units, executable_units & output)
+			{
+				check_range(units, input.units.size());
+				output.resize(units.size);
+				for(flat_index i = 0; i < units.size; i++)
+					expand_unit(units.offset + i, output[i]);
+			}
+
+			void expand_unit(flat_index index, executable_unit & output)
+			{
+				visit(visited_units, index);
+				flat_unit const & unit = input.units[index];
+
+				//the type is only set once the member exists so a unit is always safe to destroy
+				executable_unit_type::type type = get_enum(unit.type, executable_unit_type::while_statement);
+				switch(type)
+				{
+					case executable_unit_type::statement:
+					case executable_unit_type::return_statement:
+						output.statement_pointer = new parse_tree_node;
+						output.type = type;
+						expand_node(unit.index, *output.statement_pointer);
+						break;
+
+					case executable_unit_type::if_statement:
+					{
+						flat_if_statement const & statement = get_element(input.if_statements, unit.index);
+						output.if_pointer = new if_statement;
+						output.type = type;
+						expand_node(statement.conditional_term, output.if_pointer->conditional_term);
+						expand_units(statement.body, output.if_pointer->body);
+						break;
+					}
+
+					case executable_unit_type::if_else_statement:
+					{
+						flat_if_else_statement const & statement = get_element(input.if_else_statements, unit.index);
+						output.if_else_pointer = new if_else_statement;
+						output.type = type;
+						expand_node(statement.conditional_term, output.if_else_pointer->conditional_term);
+						expand_units(statement.if_body, output.if_else_pointer->if_body);
+						expand_units(statement.else_body, output.if_else_pointer->else_body);
+						break;
+					}
+
+					case executable_unit_type::for_each_statement:
+					{
+						flat_for_each_statement const & statement = get_element(input.for_each_statements, unit.index);
+						output.for_each_pointer = new for_each_statement;
+						output.type = type;
+						expand_node(statement.container, output.for_each_pointer->container);
+						expand_units(statement.body, output.for_each_pointer->body);
+						break;
+					}
+
+					case executable_unit_type::for_statement:
+					{
+						flat_for_statement const & statement = get_element(input.for_statements, unit.index);
+						output.for_pointer = new for_statement;
+						output.type = type;
+						expand_node(statement.initialisation, output.for_pointer->initialisation);
+						expand_node(statement.conditional, output.for_pointer->conditional);
+						expand_node(statement.iteration, output.for_pointer->iteration);
+						expand_units(statement.body, output.for_pointer->body);
+						break;
+					}
+
+					case executable_unit_type::while_statement:
+					{
+						flat_while_statement const & statement = get_element(input.while_statements, unit.index);
+						output.while_pointer = new while_statement;
+						output.type = type;
+						expand_node(statement.conditional_term, output.while_pointer->conditional_term);
+						expand_units(statement.body, output.while_pointer->body);
+						break;
+					}
+
+					default:
+						invalid_flat_module_error();
+				}
+			}
+
+			void expand_nodes(flat_range nodes, parse_tree_nodes & output)
+			{
+				check_range(nodes, input.nodes.size());
+				output.resize(nodes.size);
+				for(flat_index i = 0; i < nodes.size; i++)
+					expand_node(nodes.offset + i, output[i]);
+			}
+
+			void expand_node(flat_index index, parse_tree_node & output)
+			{
+				visit(visited_nodes, index);
+				flat_node const & node = input.nodes[index];
+
+				parse_tree_node_type::type type = get_enum(node.type, parse_tree_node_type::iterator);
+				switch(type)
+				{
+					case parse_tree_node_type::variable:
+						output.variable_pointer = new variable;
+						output.type = type;
+						expand_constant(node.index, *output.variable_pointer);
+						break;
+
+					case parse_tree_node_type::symbol:
+					{
+						flat_symbol const & symbol = get_element(input.symbols, node.index);
+						output.symbol_pointer = new parse_tree_symbol;
+						output.type = type;
+						output.symbol_pointer->name = get_name(symbol.name);
+						output.symbol_pointer->type = get_enum(symbol.type, symbol_prefix::class_operator);
+						break;
+					}
+
+					case parse_tree_node_type::unary_operator_node:
+					{
+						flat_unary_operator_node const & unary_operator_node = get_element(input.unary_operator_nodes, node.index);
+						output.unary_operator_pointer = new parse_tree_unary_operator_node;
+						output.type = type;
+						output.unary_operator_pointer->type = get_enum(unary_operator_node.type, unary_operator_type::decrement);
+						expand_node(unary_operator_node.argument, output.unary_operator_pointer->argument);
+						break;
+					}
+
+					case parse_tree_node_type::binary_operator_node:
+					{
+						flat_binary_operator_node const & binary_operator_node = get_element(input.binary_operator_nodes, node.index);
+						output.binary_operator_pointer = new parse_tree_binary_operator_node;
+						output.type = type;
+						output.binary_operator_pointer->type = get_enum(binary_operator_node.type, binary_operator_type::exponentiation_assignment);
+						expand_node(binary_operator_node.left_argument, output.binary_operator_pointer->left_argument);
+						expand_node(binary_operator_node.right_argument, output.binary_operator_pointer->right_argument);
+						break;
+					}
+
+					case parse_tree_node_type::call:
+					{
+						flat_call const & call = get_element(input.calls, node.index);
+						output.call_pointer = new parse_tree_call;
+						output.type = type;
+						expand_node(call.function, output.call_pointer->function);
+						expand_nodes(call.arguments, output.call_pointer->arguments);
+						break;
+					}
+
+					case parse_tree_node_type::array:
+					{
+						flat_range elements = get_element(input.arrays, node.index);
+						output.array_pointer = new parse_tree_array;
+						output.type = type;
+						expand_nodes(elements, output.array_pointer->elements);
+						break;
+					}
+
+					default:
+						output.type = type;
+						break;
+				}
+			}
+
+			void expand_constant(flat_index index, variable & output)
+			{
+				flat_constant const & constant = get_element(input.constants, index);
+				//strings are the only constants which refer to another array
+				if(get_enum(constant.type, variable_type_identifier::string) == variable_type_identifier::string)
+				{
+					if(constant.unsigned_integer >= input.strings.size())
+						invalid_flat_module_error();
+					check_range(input.strings[static_cast<std::size_t>(constant.unsigned_integer)], input.characters.size());
+				}
+				input.get_constant(index, output);
+			}
+		};
+	}
+
+	void flat_module::clear()
+	{
+		symbol_tree_nodes.clear();
+		functions.clear();
+		argument_names.clear();
+
+		units.clear();
+		if_statements.clear();
+		if_else_statements.clear();
+		for_each_statements.clear();
+		for_statements.clear();
+		while_statements.clear();
+
+		nodes.clear();
+		constants.clear();
+		symbols.clear();
+		unary_operator_nodes.clear();
+		binary_operator_nodes.clear();
+		calls.clear();
+		arrays.clear();
+
+		strings.clear();
+		characters.clear();
+	}
+
+	std::string flat_module::get_string(flat_index index) const
+	{
+		flat_range range = strings[index];
+		return characters.substr(range.offset, range.size);
+	}
+
+	void flat_module::get_constant(flat_index index, variable & output) const
+	{
+		flat_constant const & constant = constants[index];
+		switch(constant.type)
+		{
+			case variable_type_identifier::undefined:
+				break;
+
+			case variable_type_identifier::nil:
+				output.nil();
+				break;
+
+			case variable_type_identifier::none:
+				output.none();
+				break;
+
+			case variable_type_identifier::boolean:
+				output.new_boolean(constant.unsigned_integer != 0);
+				break;
+
+			case variable_type_identifier::signed_integer:
+				output.new_signed_integer(static_cast<types::signed_integer>(constant.signed_integer));
+				break;
+
+			case variable_type_identifier::unsigned_integer:
+				output.new_unsigned_integer(static_cast<types::unsigned_integer>(constant.unsigned_integer));
+				break;
+
+			case variable_type_identifier::floating_point_value:
+				output.new_floating_point_value(constant.floating_point_value);
+				break;
+
+			case variable_type_identifier::string:
+				output.new_string(get_string(static_cast<flat_index>(constant.unsigned_integer)));
+				break;
+		}
+	}
+
+	std::string flat_module::to_string(flat_index node) const
+	{
+		flat_node const & input = nodes[node];
+		switch(input.type)
+		{
+			case parse_tree_node_type::uninitialised:
+				return "uninitialised";
+
+			case parse_tree_node_type::variable:
+				return "variable";
+
+			case parse_tree_node_type::symbol:
+				return "symbol: " + get_string(symbols[input.index].name) + " (" + ail::hex_string_32(input.index) + ")";
+
+			case parse_tree_node_type::unary_operator_node:
+				return "unary operator (" + to_string(unary_operator_nodes[input.index].argument) + ")";
+
+			case parse_tree_node_type::binary_operator_node:
+			{
+				flat_binary_operator_node const & binary_operator_node = binary_operator_nodes[input.index];
+				return "binary operator (" + to_string(binary_operator_node.left_argument) + ", " + to_string(binary_operator_node.right_argument) + ")";
+			}
+
+			case parse_tree_node_type::call:
+			{
+				flat_call const & call = calls[input.index];
+				std::string output = "call: (" + to_string(call.function) + ") arguments: ";
+				if(call.arguments.size == 0)
+					output += "no arguments.";
+				else
+				{
+					for(flat_index i = 0; i < call.arguments.size; i++)
+					{
+						if(i > 0)
+							output += ", ";
+						output += "(" + to_string(call.arguments.offset + i) + ")";
+					}
+				}
+				return output;
+			}
+
+			case parse_tree_node_type::array:
+				return "array";
+
+			case parse_tree_node_type::call_operator:
+				return "call operator";
+
+			case parse_tree_node_type::spaced_call_operator:
+				return "spaced call operator";
+
+			case parse_tree_node_type::iterator:
+				return "iterator";
+
+			default:
+				return "unknown (" + ail::number_to_string(static_cast<int>(input.type)) + ")";
+		}
+	}
+
+	void flatten_module(module const & input, flat_module & output)
+	{
+		module_flattener flattener(output);
+		flattener.flatten(input);
+	}
+
+	void expand_module(flat_module const & input, module & output)
+	{
+		//the trees are built next to the ones of the output and only replace them once the entire flat module has been expanded
+		arena_scope scope(output.arena);
+		symbol_tree_node symbols;
+		function entry_function;
+		module_expander expander(input);
+		expander.expand(symbols, entry_function);
+
+		std::swap(output.symbols.type, symbols.type);
+		std::swap(output.symbols.function_pointer, symbols.function_pointer);
+		output.symbols.children.swap(symbols.children);
+		for(node_children::iterator i = output.symbols.children.begin(), end = output.symbols.children.end(); i != end; i++)
+			i->second->parent = &output.symbols;
+
+		output.entry_function.arguments.swap(entry_function.arguments);
+		output.entry_function.body.swap(entry_function.body);
+	}
+}
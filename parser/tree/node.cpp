@@ -1,4 +1,5 @@
 #include <iostream>
+#include <algorithm>
 #include <map>
 #include <fridh/symbol.hpp>
 #include <ail/string.hpp>
@@ -27,6 +28,36 @@ namespace fridh
 		return *this;
 	}
 
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+	parse_tree_node::parse_tree_node(parse_tree_node && other) BOOST_NOEXCEPT
+	{
+		move(other);
+	}
+
+	parse_tree_node & parse_tree_node::operator=(parse_tree_node && other) BOOST_NOEXCEPT
+	{
+		if(this != &other)
+		{
+			destroy();
+			move(other);
+		}
+		return *this;
+	}
+#endif
+
+	void parse_tree_node::move(parse_tree_node & other) BOOST_NOEXCEPT
+	{
+		type = other.type;
+		variable_pointer = other.variable_pointer;
+		other.type = parse_tree_node_type::uninitialised;
+	}
+
+	void parse_tree_node::swap(parse_tree_node & other) BOOST_NOEXCEPT
+	{
+		std::swap(type, other.type);
+		std::swap(variable_pointer, other.variable_pointer);
+	}
+
 	void parse_tree_node::copy(parse_tree_node const & other)
 	{
 
@@ -104,7 +135,7 @@ namespace fridh
 		type(parse_tree_node_type::array)
 	{
 		array_pointer = new parse_tree_array;
-		array_pointer->elements = elements;
+		array_pointer->elements.swap(elements);
 	}
 
 	void parse_tree_node::is_call()
@@ -136,7 +167,7 @@ namespace fridh
 				return "variable";
 
 			case parse_tree_node_type::symbol:
-				return "symbol: " + symbol_pointer->name + " (" + ail::hex_string_32((ulong)symbol_pointer) + ")";
+				return "symbol: " + get_atom_string(symbol_pointer->name) + " (" + ail::hex_string_32((ulong)symbol_pointer) + ")";
 
 			case parse_tree_node_type::unary_operator_node:
 				return "unary operator (" + unary_operator_pointer->argument.to_string() + ")";
@@ -6,7 +6,15 @@
 namespace fridh
 {
 	parse_tree_symbol::parse_tree_symbol():
-		type(symbol_prefix::none)
+		name(0),
+		type(symbol_prefix::none),
+		slot(no_slot),
+		function_node(0)
+	{
+	}
+
+	function::function():
+		local_count(0)
 	{
 	}
 }
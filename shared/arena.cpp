@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <new>
+#include <boost/thread/tss.hpp>
+#include <fridh/arena.hpp>
+
+namespace fridh
+{
+	namespace
+	{
+		//every allocation is prefixed with a header holding the owning arena, the size keeps the objects 16-byte aligned
+		std::size_t const alignment = 16;
+		std::size_t const header_size = alignment;
+
+		void release_arena(memory_arena * /*arena*/)
+		{
+			//the arenas are owned by their modules, not by the threads using them
+		}
+
+		boost::thread_specific_ptr<memory_arena> current_arena(&release_arena);
+
+		std::size_t align_size(std::size_t size)
+		{
+			return (size + alignment - 1) & ~(alignment - 1);
+		}
+	}
+
+	memory_arena::memory_arena(std::size_t block_size):
+		current(0),
+		remaining(0),
+		block_size(block_size),
+		allocation_count(0),
+		size(0)
+	{
+	}
+
+	memory_arena::~memory_arena()
+	{
+		clear();
+	}
+
+	void * memory_arena::allocate(std::size_t allocation_size)
+	{
+		allocation_size = align_size(allocation_size);
+		if(allocation_size > remaining)
+		{
+			//large allocations get a block of their own so the rest of the current block isn't wasted
+			if(allocation_size > block_size / 4)
+			{
+				char * block = new char[allocation_size];
+				blocks.push_back(block);
+				allocation_count++;
+				size += allocation_size;
+				return block;
+			}
+
+			current = new char[block_size];
+			remaining = block_size;
+			blocks.push_back(current);
+		}
+
+		void * output = current;
+		current += allocation_size;
+		remaining -= allocation_size;
+		allocation_count++;
+		size += allocation_size;
+		return output;
+	}
+
+	void memory_arena::clear()
+	{
+		for(std::vector<char *>::iterator i = blocks.begin(), end = blocks.end(); i != end; i++)
+			delete[] *i;
+		blocks.clear();
+		current = 0;
+		remaining = 0;
+		allocation_count = 0;
+		size = 0;
+	}
+
+	void memory_arena::swap(memory_arena & other)
+	{
+		//the allocations only record whether they belong to an arena at all so the blocks may change their owner
+		blocks.swap(other.blocks);
+		std::swap(current, other.current);
+		std::swap(remaining, other.remaining);
+		std::swap(block_size, other.block_size);
+		std::swap(allocation_count, other.allocation_count);
+		std::swap(size, other.size);
+	}
+
+	uword memory_arena::get_allocation_count() const
+	{
+		return allocation_count;
+	}
+
+	uword memory_arena::get_size() const
+	{
+		return size;
+	}
+
+	arena_scope::arena_scope(memory_arena & arena):
+		previous_arena(current_arena.get())
+	{
+		current_arena.reset(&arena);
+	}
+
+	arena_scope::~arena_scope()
+	{
+		current_arena.reset(previous_arena);
+	}
+
+	memory_arena * get_current_arena()
+	{
+		return current_arena.get();
+	}
+
+	void * arena_allocate(std::size_t size)
+	{
+		memory_arena * arena = current_arena.get();
+		char * memory;
+		if(arena == 0)
+			memory = static_cast<char *>(::operator new(header_size + size));
+		else
+			memory = static_cast<char *>(arena->allocate(header_size + size));
+		*reinterpret_cast<memory_arena **>(memory) = arena;
+		return memory + header_size;
+	}
+
+	void arena_deallocate(void * pointer)
+	{
+		if(pointer == 0)
+			return;
+
+		char * memory = static_cast<char *>(pointer) - header_size;
+		if(*reinterpret_cast<memory_arena **>(memory) == 0)
+			::operator delete(memory);
+	}
+}
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <boost/atomic.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/once.hpp>
+#include <ail/exception.hpp>
+#include <fnv/fnv.hpp>
+#include <fridh/atom.hpp>
+
+namespace fridh
+{
+	namespace
+	{
+		std::size_t const initial_slot_count = 1024;
+
+		//the entries are stored in pages which are never moved or freed so they can be read without the lock
+		std::size_t const page_bits = 12;
+		std::size_t const page_size = static_cast<std::size_t>(1) << page_bits;
+		std::size_t const page_count = 4096;
+
+		struct atom_entry
+		{
+			std::string name;
+			uword hash;
+		};
+
+		//open addressing with linear probing, the slots contain atoms plus one so zero marks an empty slot
+		struct slot_table
+		{
+			std::size_t size;
+			boost::atomic<atom> * slots;
+
+			slot_table(std::size_t size);
+		};
+
+		slot_table::slot_table(std::size_t size):
+			size(size),
+			slots(new boost::atomic<atom>[size])
+		{
+			for(std::size_t i = 0; i < size; i++)
+				slots[i].store(0, boost::memory_order_relaxed);
+		}
+
+		/*
+		Names which are already in the table are looked up without taking the lock, only adding a name does.
+		An entry is complete before the count and its slot are published so a reader which finds an atom also sees its entry.
+		*/
+		struct atom_table
+		{
+			boost::mutex mutex;
+
+			atom_entry * pages[page_count];
+			boost::atomic<boost::uint32_t> count;
+
+			boost::atomic<slot_table *> slots;
+			//readers may still be searching the tables which have been replaced so they are kept
+			std::vector<slot_table *> old_slots;
+
+			atom_table();
+		};
+
+		atom_table::atom_table():
+			count(0),
+			slots(new slot_table(initial_slot_count))
+		{
+			std::fill(pages, pages + page_count, static_cast<atom_entry *>(0));
+		}
+
+		atom_table * table;
+		boost::once_flag table_flag = BOOST_ONCE_INIT;
+
+		void create_table()
+		{
+			table = new atom_table;
+		}
+
+		atom_table & get_table()
+		{
+			boost::call_once(table_flag, &create_table);
+			return *table;
+		}
+
+		atom_entry const & get_entry(atom_table const & table, atom input)
+		{
+			return table.pages[input >> page_bits][input & (page_size - 1)];
+		}
+
+		//provides the empty slot at the end of the probe sequence if the name isn't in the table
+		bool find_atom(atom_table const & table, slot_table const & slots, char const * name, std::size_t size, uword hash, atom & output, std::size_t & slot)
+		{
+			std::size_t mask = slots.size - 1;
+			for(slot = static_cast<std::size_t>(hash) & mask; ; slot = (slot + 1) & mask)
+			{
+				atom value = slots.slots[slot].load(boost::memory_order_acquire);
+				if(value == 0)
+					return false;
+
+				atom_entry const & entry = get_entry(table, value - 1);
+				if(entry.hash == hash && entry.name.size() == size && std::memcmp(entry.name.data(), name, size) == 0)
+				{
+					output = value - 1;
+					return true;
+				}
+			}
+		}
+
+		void grow_table(atom_table & table)
+		{
+			slot_table & old_slots = *table.slots.load(boost::memory_order_relaxed);
+			slot_table * new_slots = new slot_table(old_slots.size * 2);
+			std::size_t mask = new_slots->size - 1;
+			for(atom i = 0, end = table.count.load(boost::memory_order_relaxed); i < end; i++)
+			{
+				std::size_t slot = static_cast<std::size_t>(get_entry(table, i).hash) & mask;
+				while(new_slots->slots[slot].load(boost::memory_order_relaxed) != 0)
+					slot = (slot + 1) & mask;
+				new_slots->slots[slot].store(i + 1, boost::memory_order_relaxed);
+			}
+			table.old_slots.push_back(&old_slots);
+			table.slots.store(new_slots, boost::memory_order_release);
+		}
+	}
+
+	atom get_atom(std::string const & name)
+	{
+		return get_atom(name.c_str(), name.size());
+	}
+
+	atom get_atom(char const * name, std::size_t size)
+	{
+		atom_table & table = get_table();
+		uword hash = fnv1a_hash(name, size, 0);
+
+		//almost every name has been seen before so the lock is only taken if the name appears to be missing
+		atom output;
+		std::size_t slot;
+		if(find_atom(table, *table.slots.load(boost::memory_order_acquire), name, size, hash, output, slot))
+			return output;
+
+		boost::mutex::scoped_lock lock(table.mutex);
+
+		//another thread may have added the name or grown the table in the meantime
+		slot_table & slots = *table.slots.load(boost::memory_order_relaxed);
+		if(find_atom(table, slots, name, size, hash, output, slot))
+			return output;
+
+		atom new_atom = table.count.load(boost::memory_order_relaxed);
+		if(new_atom >= page_count * page_size)
+			throw ail::exception("Too many distinct names");
+
+		atom_entry * & page = table.pages[new_atom >> page_bits];
+		if(page == 0)
+			page = new atom_entry[page_size];
+		atom_entry & entry = page[new_atom & (page_size - 1)];
+		entry.name.assign(name, size);
+		entry.hash = hash;
+
+		table.count.store(new_atom + 1, boost::memory_order_release);
+		slots.slots[slot].store(new_atom + 1, boost::memory_order_release);
+
+		//the load factor is kept below one half so the probe sequences stay short
+		if((new_atom + 1) * 2 > slots.size)
+			grow_table(table);
+
+		return new_atom;
+	}
+
+	std::string const & get_atom_string(atom input)
+	{
+		atom_table & table = get_table();
+		if(input >= table.count.load(boost::memory_order_acquire))
+			throw ail::exception("Invalid atom");
+		return get_entry(table, input).name;
+	}
+
+	uword get_atom_count()
+	{
+		return get_table().count.load(boost::memory_order_acquire);
+	}
+}
@@ -2,11 +2,16 @@
 
 namespace fridh
 {
-	void construction_pattern::copy(construction_pattern const & other)
+	void construction_pattern::copy(construction_pattern const & /*other*/)
 	{
 		throw ail::exception("Construction pattern copy requested");
 	}
 
+	void construction_pattern::move(construction_pattern & /*other*/)
+	{
+		throw ail::exception("Construction pattern move requested");
+	}
+
 	void construction_pattern::destroy()
 	{
 		throw ail::exception("Construction pattern destruction requested");
@@ -21,6 +26,13 @@ namespace fridh
 		copy(other);
 	}
 
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+	construction_pattern::construction_pattern(construction_pattern && other)
+	{
+		move(other);
+	}
+#endif
+
 	construction_pattern::~construction_pattern()
 	{
 		destroy();
@@ -32,4 +44,16 @@ namespace fridh
 		copy(other);
 		return *this;
 	}
+
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+	construction_pattern & construction_pattern::operator=(construction_pattern && other)
+	{
+		if(this != &other)
+		{
+			destroy();
+			move(other);
+		}
+		return *this;
+	}
+#endif
 }
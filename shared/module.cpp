@@ -0,0 +1,16 @@
+#include <fridh/symbol.hpp>
+
+namespace fridh
+{
+	module::module()
+	{
+	}
+
+	module::module(module const & other):
+		path(other.path)
+	{
+		arena_scope scope(arena);
+		symbols = other.symbols;
+		entry_function = other.entry_function;
+	}
+}
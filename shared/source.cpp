@@ -0,0 +1,118 @@
+#include <fridh/source.hpp>
+
+#ifdef _WIN32
+#include <ail/file.hpp>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace fridh
+{
+	source_buffer::source_buffer():
+		mapped_data(0),
+		mapped_size(0)
+	{
+	}
+
+	source_buffer::~source_buffer()
+	{
+		clear();
+	}
+
+	void source_buffer::clear()
+	{
+#ifndef _WIN32
+		if(mapped_data != 0)
+			munmap(const_cast<char *>(mapped_data), mapped_size);
+#endif
+		mapped_data = 0;
+		mapped_size = 0;
+		content.clear();
+	}
+
+#ifdef _WIN32
+
+	bool source_buffer::load(std::string const & path)
+	{
+		clear();
+		return ail::read_file(path, content);
+	}
+
+#else
+
+	bool source_buffer::load(std::string const & path)
+	{
+		clear();
+
+		if(path == "-")
+			return read_descriptor(STDIN_FILENO);
+
+		int descriptor = open(path.c_str(), O_RDONLY);
+		if(descriptor == -1)
+			return false;
+
+		struct stat status;
+		if(fstat(descriptor, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0)
+		{
+			std::size_t size = static_cast<std::size_t>(status.st_size);
+			void * address = mmap(0, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+			if(address != MAP_FAILED)
+			{
+				//the lexer reads the file front to back exactly once
+				madvise(address, size, MADV_SEQUENTIAL);
+				mapped_data = static_cast<char const *>(address);
+				mapped_size = size;
+				close(descriptor);
+				return true;
+			}
+		}
+
+		bool success = read_descriptor(descriptor);
+		close(descriptor);
+		return success;
+	}
+
+	bool source_buffer::read_descriptor(int descriptor)
+	{
+		char chunk[64 * 1024];
+		while(true)
+		{
+			ssize_t bytes_read = read(descriptor, chunk, sizeof(chunk));
+			if(bytes_read == 0)
+				return true;
+			else if(bytes_read < 0)
+			{
+				if(errno == EINTR)
+					continue;
+				content.clear();
+				return false;
+			}
+			content.append(chunk, static_cast<std::size_t>(bytes_read));
+		}
+	}
+
+#endif
+
+	char const * source_buffer::data() const
+	{
+		if(mapped_data != 0)
+			return mapped_data;
+		return content.data();
+	}
+
+	std::size_t source_buffer::size() const
+	{
+		if(mapped_data != 0)
+			return mapped_size;
+		return content.size();
+	}
+
+	bool source_buffer::is_mapped() const
+	{
+		return mapped_data != 0;
+	}
+}
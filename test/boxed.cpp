@@ -0,0 +1,234 @@
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+#include <fridh/boxed_variable.hpp>
+
+#include <ail/string.hpp>
+
+#include <test/test.hpp>
+
+namespace
+{
+	typedef void (fridh::variable::* binary_operator)(fridh::variable const & argument, fridh::variable & output) const;
+	typedef void (fridh::boxed_variable::* boxed_binary_operator)(fridh::boxed_variable const & argument, fridh::boxed_variable & output) const;
+
+	struct operator_pair
+	{
+		char const * name;
+		binary_operator regular;
+		boxed_binary_operator boxed;
+	};
+
+	operator_pair const binary_operators[] =
+	{
+		{"addition", &fridh::variable::addition, &fridh::boxed_variable::addition},
+		{"subtraction", &fridh::variable::subtraction, &fridh::boxed_variable::subtraction},
+		{"multiplication", &fridh::variable::multiplication, &fridh::boxed_variable::multiplication},
+		{"division", &fridh::variable::division, &fridh::boxed_variable::division},
+		{"modulo", &fridh::variable::modulo, &fridh::boxed_variable::modulo},
+		{"less than", &fridh::variable::less_than, &fridh::boxed_variable::less_than},
+		{"less than or equal", &fridh::variable::less_than_or_equal, &fridh::boxed_variable::less_than_or_equal},
+		{"greater than", &fridh::variable::greater_than, &fridh::boxed_variable::greater_than},
+		{"greater than or equal", &fridh::variable::greater_than_or_equal, &fridh::boxed_variable::greater_than_or_equal},
+		{"not equal", &fridh::variable::not_equal, &fridh::boxed_variable::not_equal},
+		{"equal", &fridh::variable::equal, &fridh::boxed_variable::equal},
+		{"binary and", &fridh::variable::binary_and, &fridh::boxed_variable::binary_and},
+		{"binary or", &fridh::variable::binary_or, &fridh::boxed_variable::binary_or},
+		{"binary xor", &fridh::variable::binary_xor, &fridh::boxed_variable::binary_xor}
+	};
+
+	//the values around the 48-bit limit of the inline integers are the interesting ones
+	std::vector<fridh::variable> get_numbers()
+	{
+		fridh::types::signed_integer const limit = static_cast<fridh::types::signed_integer>(1) << 47;
+		fridh::types::signed_integer const signed_integers[] = {0, 1, -1, 7, -3, limit - 1, - limit, limit, - limit - 1};
+		double const floating_point_values[] = {0.0, -0.0, 1.5, -2.25, 1e300};
+
+		std::vector<fridh::variable> output;
+		for(std::size_t i = 0; i < sizeof(signed_integers) / sizeof(signed_integers[0]); i++)
+		{
+			fridh::variable number;
+			number.new_signed_integer(signed_integers[i]);
+			output.push_back(number);
+		}
+		for(std::size_t i = 0; i < sizeof(floating_point_values) / sizeof(floating_point_values[0]); i++)
+		{
+			fridh::variable number;
+			number.new_floating_point_value(floating_point_values[i]);
+			output.push_back(number);
+		}
+		fridh::variable number;
+		number.new_unsigned_integer(5);
+		output.push_back(number);
+		number.new_unsigned_integer(UINT64_C(0xffffffffffffffff));
+		output.push_back(number);
+		return output;
+	}
+
+	bool is_large(fridh::variable const & input)
+	{
+		if(input.get_type() == fridh::variable_type_identifier::floating_point_value)
+			return false;
+		fridh::types::signed_integer value = input.get_signed_integer();
+		return value > 0xffff || value < -0xffff;
+	}
+
+	std::string describe(fridh::variable const & input)
+	{
+		std::string output = ail::number_to_string(static_cast<int>(input.get_type()));
+		switch(input.get_type())
+		{
+			case fridh::variable_type_identifier::boolean:
+			case fridh::variable_type_identifier::signed_integer:
+			case fridh::variable_type_identifier::unsigned_integer:
+			case fridh::variable_type_identifier::floating_point_value:
+			case fridh::variable_type_identifier::string:
+				output += ":" + input.get_string_representation();
+				break;
+
+			default:
+				break;
+		}
+		return output;
+	}
+
+	std::string apply(binary_operator function, fridh::variable const & left, fridh::variable const & right)
+	{
+		try
+		{
+			fridh::variable output;
+			(left.*function)(right, output);
+			return describe(output);
+		}
+		catch(ail::exception & exception)
+		{
+			return "Error: " + exception.get_message();
+		}
+	}
+
+	std::string apply(boxed_binary_operator function, fridh::variable const & left, fridh::variable const & right)
+	{
+		try
+		{
+			fridh::boxed_variable boxed_left(left), boxed_right(right), boxed_output;
+			(boxed_left.*function)(boxed_right, boxed_output);
+			fridh::variable output;
+			boxed_output.to_variable(output);
+			return describe(output);
+		}
+		catch(ail::exception & exception)
+		{
+			return "Error: " + exception.get_message();
+		}
+	}
+
+	void test_conversions()
+	{
+		std::vector<fridh::variable> values = get_numbers();
+		fridh::variable value;
+		value.nil();
+		values.push_back(value);
+		value.none();
+		values.push_back(value);
+		value.new_boolean(true);
+		values.push_back(value);
+		value.new_boolean(false);
+		values.push_back(value);
+		value.new_string("text");
+		values.push_back(value);
+
+		for(std::size_t i = 0; i < values.size(); i++)
+		{
+			fridh::variable const & input = values[i];
+			fridh::boxed_variable boxed(input);
+			fridh::variable output;
+			boxed.to_variable(output);
+			std::string description = "Boxed conversion of " + describe(input);
+			check(description + " (type)", boxed.get_type() == input.get_type() && output.get_type() == input.get_type());
+			check(description + " (value)", output == input);
+		}
+
+		fridh::boxed_variable nan;
+		nan.new_floating_point_value(0.0 / 0.0);
+		check("Boxed NaN", nan.get_type() == fridh::variable_type_identifier::floating_point_value && nan != nan);
+	}
+
+	void test_operators()
+	{
+		std::vector<fridh::variable> numbers = get_numbers();
+		for(std::size_t i = 0; i < sizeof(binary_operators) / sizeof(binary_operators[0]); i++)
+		{
+			operator_pair const & pair = binary_operators[i];
+			std::string mismatch;
+			for(std::size_t left = 0; left < numbers.size() && mismatch.empty(); left++)
+			{
+				for(std::size_t right = 0; right < numbers.size() && mismatch.empty(); right++)
+				{
+					//the overflow of signed multiplications is undefined in the regular implementation
+					if(pair.regular == &fridh::variable::multiplication && is_large(numbers[left]) && is_large(numbers[right]))
+						continue;
+					std::string
+						expected = apply(pair.regular, numbers[left], numbers[right]),
+						result = apply(pair.boxed, numbers[left], numbers[right]);
+					if(result != expected)
+						mismatch = describe(numbers[left]) + ", " + describe(numbers[right]) + ": expected \"" + expected + "\" but got \"" + result + "\"";
+				}
+			}
+			check("Boxed " + std::string(pair.name), mismatch, "");
+		}
+
+		for(std::size_t i = 0; i < numbers.size(); i++)
+		{
+			fridh::variable expected;
+			numbers[i].negation(expected);
+			fridh::boxed_variable boxed(numbers[i]), boxed_output;
+			boxed.negation(boxed_output);
+			fridh::variable output;
+			boxed_output.to_variable(output);
+			check("Boxed negation of " + describe(numbers[i]), describe(output), describe(expected));
+		}
+	}
+
+	//copies share strings, arrays and maps until they get modified
+	void test_payload_sharing()
+	{
+		fridh::boxed_variable array;
+		array.new_array();
+		for(fridh::types::signed_integer i = 0; i < 4; i++)
+		{
+			fridh::boxed_variable element;
+			element.new_signed_integer(i);
+			array.get_array().push_back(element);
+		}
+
+		fridh::boxed_variable copy(array);
+		fridh::boxed_variable const & const_array = array;
+		fridh::boxed_variable const & const_copy = copy;
+		check("Boxed array copy shares its payload", &const_copy.get_array() == &const_array.get_array());
+
+		fridh::boxed_variable element;
+		element.new_string("added");
+		copy.get_array().push_back(element);
+		check("Boxed array copy detaches on modification", &const_copy.get_array() != &const_array.get_array());
+		check("Boxed array original after modifying the copy", const_array.get_array().size() == 4 && const_copy.get_array().size() == 5);
+
+		fridh::variable string;
+		string.new_string("shared");
+		fridh::boxed_variable boxed_string(string);
+		check("Boxed string shares the payload of the variable", &boxed_string.get_string() == &string.get_string());
+
+		fridh::variable converted;
+		array.to_variable(converted);
+		fridh::boxed_variable round_trip(converted);
+		check("Boxed array round trip", round_trip == array);
+	}
+}
+
+void test_boxed()
+{
+	check("Size of a boxed variable", sizeof(fridh::boxed_variable) == 8);
+	test_conversions();
+	test_operators();
+	test_payload_sharing();
+}
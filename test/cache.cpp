@@ -0,0 +1,177 @@
+#include <cstdio>
+
+#include <fridh/parser.hpp>
+#include <fridh/flat.hpp>
+#include <fridh/cache.hpp>
+#include <fridh/interpreter.hpp>
+
+#include <ail/file.hpp>
+#include <ail/string.hpp>
+
+#include <test/test.hpp>
+
+namespace
+{
+	std::string const cache_test_code =
+		"@f a b\n"
+		"\tx = a + b * 3 - -a / 2\n"
+		"\ty = {a b x 1}\n"
+		"\ts = \"text\"\n"
+		"\tz = 1.5\n"
+		"\t/ x > b\n"
+		"\t\tx = 2 * g[a]\n"
+		"\t/\n"
+		"\t\tx++\n"
+		"\t\\ y\n"
+		"\t\tx += # << 1\n"
+		"\t. x\n"
+		"\n"
+		"@g a\n"
+		"\ti = 0\n"
+		"\tsum = 0\n"
+		"\t\\\\ i < a\n"
+		"\t\tsum += i\n"
+		"\t\ti++\n"
+		"\t. sum\n"
+		"\n"
+		". f[3 4] + g[10]\n";
+
+	//the sizes of the flat arrays followed by every unit in the format of flat_module::to_string
+	std::string get_flat_signature(fridh::module const & input)
+	{
+		fridh::flat_module flat;
+		fridh::flatten_module(input, flat);
+
+		std::string output =
+			ail::number_to_string(flat.symbol_tree_nodes.size()) + " " +
+			ail::number_to_string(flat.functions.size()) + " " +
+			ail::number_to_string(flat.argument_names.size()) + " " +
+			ail::number_to_string(flat.units.size()) + " " +
+			ail::number_to_string(flat.if_statements.size()) + " " +
+			ail::number_to_string(flat.if_else_statements.size()) + " " +
+			ail::number_to_string(flat.for_each_statements.size()) + " " +
+			ail::number_to_string(flat.for_statements.size()) + " " +
+			ail::number_to_string(flat.while_statements.size()) + " " +
+			ail::number_to_string(flat.nodes.size()) + " " +
+			ail::number_to_string(flat.constants.size()) + " " +
+			ail::number_to_string(flat.symbols.size()) + " " +
+			ail::number_to_string(flat.unary_operator_nodes.size()) + " " +
+			ail::number_to_string(flat.binary_operator_nodes.size()) + " " +
+			ail::number_to_string(flat.calls.size()) + " " +
+			ail::number_to_string(flat.arrays.size()) + "\n" +
+			flat.characters + "\n";
+
+		for(std::size_t i = 0; i < flat.units.size(); i++)
+		{
+			fridh::flat_unit const & unit = flat.units[i];
+			if(unit.type == fridh::executable_unit_type::statement || unit.type == fridh::executable_unit_type::return_statement)
+				output += flat.to_string(unit.index) + "\n";
+		}
+		return output;
+	}
+
+	std::string run(fridh::module & input)
+	{
+		fridh::interpreter interpreter;
+		fridh::variable result;
+		std::string error;
+		if(!interpreter.run(input, result, error))
+			return "Error: " + error;
+		return result.get_string_representation();
+	}
+
+	//a failed expansion may leave unused allocations in the arena but no trees
+	bool is_empty(fridh::module const & input)
+	{
+		return input.symbols.children.empty() && input.entry_function.arguments.empty() && input.entry_function.body.empty();
+	}
+
+	//writes a modified copy of the cache file and makes sure loading it fails without touching the output
+	void check_corrupted_load(std::string const & description, fridh::module_cache const & cache, std::string const & data)
+	{
+		std::string const & code = cache_test_code;
+		std::string path = cache.get_path(code.data(), code.size());
+		if(!ail::write_file(path, data))
+		{
+			check(description + " (write)", false);
+			return;
+		}
+
+		fridh::module output;
+		check(description, !cache.load(code.data(), code.size(), output));
+		check(description + " (output untouched)", is_empty(output));
+	}
+}
+
+void test_cache()
+{
+	std::string const & code = cache_test_code;
+
+	//the files are written to the working directory and removed again at the end
+	fridh::module_cache cache("");
+	std::string path = cache.get_path(code.data(), code.size());
+
+	fridh::module original;
+	fridh::parser parser;
+	std::string error;
+	bool success = parser.process_data(code, "cache test", original, error);
+	check("Cache test parse", success);
+	if(!success)
+		return;
+
+	std::string original_signature = get_flat_signature(original);
+
+	check("Cache store", cache.store(code.data(), code.size(), original));
+
+	fridh::module loaded;
+	success = cache.load(code.data(), code.size(), loaded);
+	check("Cache load", success);
+	if(success)
+	{
+		check("Cache round trip (flat trees)", get_flat_signature(loaded), original_signature);
+		check("Cache round trip (result)", run(loaded), run(original));
+	}
+
+	std::string different_code = code + "\n";
+	fridh::module missing;
+	check("Cache load of a different source", !cache.load(different_code.data(), different_code.size(), missing));
+
+	std::string data;
+	if(!ail::read_file(path, data))
+	{
+		check("Cache file", false);
+		std::remove(path.c_str());
+		return;
+	}
+
+	//the header is 56 bytes long, followed by the string table and the arrays of the flat module
+	std::size_t const header_size = 56;
+	check("Cache file size", data.size() > header_size);
+
+	check_corrupted_load("Empty cache file", cache, "");
+	check_corrupted_load("Truncated cache header", cache, data.substr(0, header_size - 1));
+	check_corrupted_load("Truncated cache file", cache, data.substr(0, data.size() - 1));
+	check_corrupted_load("Cache file with trailing data", cache, data + '\0');
+
+	std::string invalid_magic = data;
+	invalid_magic[0] = 'x';
+	check_corrupted_load("Cache file with an invalid magic", cache, invalid_magic);
+
+	//every array size and index in the trees is replaced in turn, decoding either fails or yields a valid module
+	for(std::size_t i = data.size() - 4; i > header_size; i -= 4)
+	{
+		std::string corrupted = data;
+		for(std::size_t j = 0; j < 4; j++)
+			corrupted[i + j] = '\xff';
+		ail::write_file(path, corrupted);
+		fridh::module output;
+		if(!cache.load(code.data(), code.size(), output) && !is_empty(output))
+		{
+			check("Corrupted cache file at offset " + ail::number_to_string(i) + " left the output untouched", false);
+			break;
+		}
+	}
+
+	std::remove(path.c_str());
+	check("Cache file removed", !ail::read_file(path, data));
+}
@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <vector>
+
+#include <fridh/parser.hpp>
+#include <fridh/incremental.hpp>
+#include <fridh/interpreter.hpp>
+
+#include <ail/string.hpp>
+
+#include <test/test.hpp>
+
+namespace
+{
+	//symbol nodes print their own address in parentheses, that part differs between any two trees
+	std::string describe_node(fridh::parse_tree_node const & node)
+	{
+		std::string input = node.to_string();
+		std::string output;
+		for(std::size_t i = 0; i < input.size(); i++)
+		{
+			if(input[i] == '(' && i + 10 <= input.size() && input[i + 9] == ')' && input.find_first_not_of("0123456789abcdef", i + 1) == i + 9)
+			{
+				output += "(node)";
+				i += 9;
+			}
+			else
+				output += input[i];
+		}
+		return output;
+	}
+
+	std::string describe_units(fridh::executable_units const & units)
+	{
+		std::string output;
+		for(fridh::executable_units::const_iterator i = units.begin(), end = units.end(); i != end; i++)
+		{
+			fridh::executable_unit const & unit = *i;
+			output += ail::number_to_string(static_cast<int>(unit.type)) + " ";
+			switch(unit.type)
+			{
+				case fridh::executable_unit_type::statement:
+				case fridh::executable_unit_type::return_statement:
+					output += describe_node(*unit.statement_pointer);
+					break;
+
+				case fridh::executable_unit_type::if_statement:
+					output += describe_node(unit.if_pointer->conditional_term) + " {" + describe_units(unit.if_pointer->body) + "}";
+					break;
+
+				case fridh::executable_unit_type::if_else_statement:
+					output += describe_node(unit.if_else_pointer->conditional_term) + " {" + describe_units(unit.if_else_pointer->if_body) + "} {" + describe_units(unit.if_else_pointer->else_body) + "}";
+					break;
+
+				case fridh::executable_unit_type::for_each_statement:
+					output += describe_node(unit.for_each_pointer->container) + " {" + describe_units(unit.for_each_pointer->body) + "}";
+					break;
+
+				case fridh::executable_unit_type::for_statement:
+					output += describe_node(unit.for_pointer->initialisation) + "; " + describe_node(unit.for_pointer->conditional) + "; " + describe_node(unit.for_pointer->iteration) + " {" + describe_units(unit.for_pointer->body) + "}";
+					break;
+
+				case fridh::executable_unit_type::while_statement:
+					output += describe_node(unit.while_pointer->conditional_term) + " {" + describe_units(unit.while_pointer->body) + "}";
+					break;
+
+				default:
+					break;
+			}
+			output += "\n";
+		}
+		return output;
+	}
+
+	void describe_functions(fridh::symbol_tree_node const & node, std::string const & prefix, std::vector<std::string> & output)
+	{
+		for(fridh::node_children::const_iterator i = node.children.begin(), end = node.children.end(); i != end; i++)
+		{
+			fridh::symbol_tree_node const & child = *i->second;
+			std::string name = prefix + fridh::get_atom_string(i->first);
+			if(child.type == fridh::symbol::function)
+				output.push_back(name + " (" + ail::number_to_string(child.function_pointer->arguments.size()) + " argument(s))\n" + describe_units(child.function_pointer->body));
+			describe_functions(child, name + ".", output);
+		}
+	}
+
+	//the symbol tree keeps the order in which the functions were added so the incremental parser appends the edited ones, they are sorted by name here
+	std::string describe_module(fridh::module const & input)
+	{
+		std::vector<std::string> functions;
+		describe_functions(input.symbols, "", functions);
+		std::sort(functions.begin(), functions.end());
+
+		std::string output = input.path + "\n" + describe_units(input.entry_function.body);
+		for(std::size_t i = 0; i < functions.size(); i++)
+			output += functions[i];
+		return output;
+	}
+
+	std::string run(fridh::module & input)
+	{
+		fridh::interpreter interpreter;
+		fridh::variable result;
+		std::string error;
+		if(!interpreter.run(input, result, error))
+			return "Error: " + error;
+		return result.get_string_representation();
+	}
+
+	std::string generate_functions(std::size_t count, std::size_t edited_function, std::string const & edited_body)
+	{
+		std::string output;
+		for(std::size_t i = 0; i < count; i++)
+		{
+			std::string name = "f" + ail::number_to_string(i);
+			output += "@" + name + " a\n";
+			if(i == edited_function)
+				output += edited_body;
+			else
+				output += "\tx = a + " + ail::number_to_string(i) + "\n\t/ x > 3\n\t\tx--\n\t. x\n";
+			output += "\n";
+		}
+		return output;
+	}
+
+	//updates an incremental module to the given versions of the source one after another and compares it with a full parse of each
+	void check_versions(std::string const & description, std::vector<std::string> const & versions)
+	{
+		fridh::module incremental_module;
+		fridh::incremental_parser incremental_parser("t", incremental_module);
+
+		for(std::size_t i = 0; i < versions.size(); i++)
+		{
+			std::string version = description + ", version " + ail::number_to_string(i + 1);
+			std::string const & code = versions[i];
+
+			std::string error;
+			bool success = incremental_parser.process_data(code.data(), code.size(), error);
+			check(version + " (incremental parse)", success);
+			if(!success)
+				return;
+
+			fridh::module full_module;
+			fridh::parser parser;
+			success = parser.process_data(code, "t", full_module, error);
+			check(version + " (full parse)", success);
+			if(!success)
+				return;
+
+			check(version + " (trees)", describe_module(incremental_module), describe_module(full_module));
+			check(version + " (result)", run(incremental_module), run(full_module));
+		}
+	}
+}
+
+void test_incremental()
+{
+	std::vector<std::string> versions;
+	versions.push_back(generate_functions(10, 10, "") + ". f3[1] + f7[2]\n");
+	//an edited function, a changed entry statement, a removed function and an added one
+	versions.push_back(generate_functions(10, 5, "\tx = a * 7\n\t. x\n") + ". f3[1] + f5[2]\n");
+	versions.push_back(generate_functions(9, 5, "\tx = a * 7\n\t. x\n") + "@g b\n\t. b - 1\n\n. f5[2] + g[10]\n");
+	//an error at run time refers to the name of the module
+	versions.push_back(generate_functions(9, 10, "") + ". f1[q]\n");
+	check_versions("Incremental module", versions);
+}
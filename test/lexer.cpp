@@ -0,0 +1,116 @@
+#include <vector>
+
+#include <fridh/lexer.hpp>
+#include <fridh/scan.hpp>
+
+#include <boost/cstdint.hpp>
+
+#include <test/test.hpp>
+
+namespace
+{
+	//a fixed sequence so failures can be reproduced
+	class random_bytes
+	{
+	public:
+		random_bytes():
+			state(1)
+		{
+		}
+
+		unsigned next(unsigned limit)
+		{
+			state = state * UINT64_C(6364136223846793005) + UINT64_C(1442695040888963407);
+			return static_cast<unsigned>(state >> 33) % limit;
+		}
+
+	private:
+		boost::uint64_t state;
+	};
+
+	//runs of name characters and spaces with delimiters and bytes outside of ASCII between them
+	std::string generate_input(random_bytes & random, std::size_t size)
+	{
+		char const alphabet[] = "abcxyzABZ019_  \r\r\t\n\"';#/+-=.[]{}\xe9\x80\xff";
+		std::string output;
+		while(output.size() < size)
+		{
+			char byte = alphabet[random.next(sizeof(alphabet) - 1)];
+			output.append(random.next(40) + 1, byte);
+		}
+		output.resize(size);
+		return output;
+	}
+
+	std::string lex(std::string const & input)
+	{
+		fridh::lines_of_code lines;
+		fridh::lexer lexer(input, lines);
+		std::string error;
+		if(!lexer.parse(error))
+			return "Error: " + error;
+		return fridh::visualise_lexemes(lines);
+	}
+}
+
+//the vector kernels must find the same offsets as the scalar ones for any input and alignment
+void test_lexer()
+{
+	std::size_t const input_count = 300;
+
+	fridh::scan_method::type const methods[] =
+	{
+		fridh::scan_method::sse2,
+		fridh::scan_method::avx2
+	};
+
+	fridh::scan_method::type default_method = fridh::get_scan_method();
+
+	random_bytes random;
+	std::vector<std::string> inputs;
+	for(std::size_t i = 0; i < input_count; i++)
+		inputs.push_back(generate_input(random, random.next(200)));
+
+	fridh::set_scan_method(fridh::scan_method::scalar);
+	fridh::scan_kernels scalar = fridh::get_scan_kernels();
+	std::vector<std::string> scalar_lexemes;
+	for(std::size_t i = 0; i < input_count; i++)
+		scalar_lexemes.push_back(lex(inputs[i]));
+
+	for(std::size_t i = 0; i < sizeof(methods) / sizeof(methods[0]); i++)
+	{
+		fridh::scan_method::type method = methods[i];
+		if(!fridh::scan_method_is_supported(method))
+			continue;
+
+		fridh::set_scan_method(method);
+		check("Selecting the " + fridh::get_scan_method_string(method) + " scan method", fridh::get_scan_method() == method);
+		fridh::scan_kernels vector = fridh::get_scan_kernels();
+
+		bool kernels_match = true;
+		bool lexemes_match = true;
+		for(std::size_t j = 0; j < input_count; j++)
+		{
+			std::string const & input = inputs[j];
+			char const * data = input.data();
+			for(std::size_t offset = 0; offset <= input.size(); offset++)
+			{
+				if(
+					vector.skip_name_characters(data, offset, input.size()) != scalar.skip_name_characters(data, offset, input.size()) ||
+					vector.skip_spaces(data, offset, input.size()) != scalar.skip_spaces(data, offset, input.size()) ||
+					vector.find_delimiter(data, offset, input.size(), '"', '\n', '\\') != scalar.find_delimiter(data, offset, input.size(), '"', '\n', '\\') ||
+					vector.find_delimiter(data, offset, input.size(), '\xe9', '\xe9', '\xe9') != scalar.find_delimiter(data, offset, input.size(), '\xe9', '\xe9', '\xe9')
+				)
+					kernels_match = false;
+			}
+
+			if(lex(input) != scalar_lexemes[j])
+				lexemes_match = false;
+		}
+
+		check("Scalar and " + fridh::get_scan_method_string(method) + " kernels", kernels_match);
+		check("Scalar and " + fridh::get_scan_method_string(method) + " lexemes", lexemes_match);
+	}
+
+	fridh::set_scan_method(default_method);
+}
@@ -0,0 +1,101 @@
+#include <iostream>
+
+#include <fridh/parser.hpp>
+#include <fridh/optimiser.hpp>
+#include <fridh/interpreter.hpp>
+#include <fridh/bytecode.hpp>
+
+#include <test/test.hpp>
+
+namespace
+{
+	uword check_count = 0;
+	uword failure_count = 0;
+}
+
+std::string execute(std::string const & code, backend::type method, bool optimise)
+{
+	fridh::module module;
+	fridh::parser parser;
+
+	std::string error;
+	if(!parser.process_data(code, "test", module, error))
+		return "Error: " + error;
+
+	if(optimise)
+		fridh::optimise_module(module);
+
+	fridh::variable result;
+	if(method == backend::interpreter)
+	{
+		fridh::interpreter interpreter;
+		if(!interpreter.run(module, result, error))
+			return "Error: " + error;
+	}
+	else
+	{
+		fridh::bytecode_program program;
+		fridh::bytecode_compiler compiler;
+		if(!compiler.compile(module, program, error))
+			return "Error: " + error;
+
+		fridh::virtual_machine machine;
+		if(!machine.run(program, result, error))
+			return "Error: " + error;
+	}
+
+	return result.get_string_representation();
+}
+
+void check_result(std::string const & description, std::string const & code, std::string const & expected)
+{
+	check(description + " (interpreter)", execute(code, backend::interpreter, false), expected);
+	check(description + " (bytecode)", execute(code, backend::bytecode, false), expected);
+	check(description + " (optimised interpreter)", execute(code, backend::interpreter, true), expected);
+	check(description + " (optimised bytecode)", execute(code, backend::bytecode, true), expected);
+}
+
+void check(std::string const & description, std::string const & result, std::string const & expected)
+{
+	check_count++;
+	if(result == expected)
+		return;
+
+	failure_count++;
+	std::cout << description << ": Expected \"" << expected << "\" but got \"" << result << "\"" << std::endl;
+}
+
+void check(std::string const & description, bool success)
+{
+	check_count++;
+	if(success)
+		return;
+
+	failure_count++;
+	std::cout << description << ": Failed" << std::endl;
+}
+
+namespace
+{
+	void test_operators()
+	{
+		//the virtual machine writes the result into a register which may still hold a string, the payload must be released under LeakSanitizer
+		check_result("Negation overwriting a string", "s = \"abc\"\ny = 2\ns = -y\n. s\n", "-2");
+		check_result("Negation overwriting a string with a floating point value", "s = \"abc\"\ny = 1.5\ns = -y\n. s\n", "-1.5");
+	}
+}
+
+int main()
+{
+	test_threads();
+	test_lexer();
+	test_operators();
+	test_parser();
+	test_optimiser();
+	test_incremental();
+	test_cache();
+	test_boxed();
+
+	std::cout << failure_count << " of " << check_count << " check(s) failed" << std::endl;
+	return failure_count == 0 ? 0 : 1;
+}
@@ -0,0 +1,89 @@
+#include <fridh/parser.hpp>
+#include <fridh/optimiser.hpp>
+#include <fridh/interpreter.hpp>
+
+#include <test/test.hpp>
+
+namespace
+{
+	//the type of the first top-level statement after folding the constants
+	bool first_statement_is(std::string const & code, fridh::parse_tree_node_type::type type)
+	{
+		fridh::module module;
+		fridh::parser parser;
+		std::string error;
+		if(!parser.process_data(code, "test", module, error))
+			return false;
+
+		fridh::optimise_module(module);
+
+		fridh::executable_units const & body = module.entry_function.body;
+		return !body.empty() && body[0].type == fridh::executable_unit_type::return_statement && body[0].statement_pointer->type == type;
+	}
+
+	//the number of top-level units of the entry function after running the module
+	std::size_t get_unit_count(std::string const & code, bool optimise)
+	{
+		fridh::module module;
+		fridh::parser parser;
+		std::string error;
+		if(!parser.process_data(code, "test", module, error))
+			return 0;
+
+		if(optimise)
+			fridh::optimise_module(module);
+
+		fridh::interpreter interpreter;
+		fridh::variable result;
+		if(!interpreter.run(module, result, error))
+			return 0;
+
+		return module.entry_function.body.size();
+	}
+
+	//the interpreter only reports errors in code which is executed while the bytecode compiler rejects the whole module, removing dead code must not change either
+	void check_rejection(std::string const & description, std::string const & code, std::string const & interpreter_result, std::string const & bytecode_error)
+	{
+		check(description + " (interpreter)", execute(code, backend::interpreter, false), interpreter_result);
+		check(description + " (optimised interpreter)", execute(code, backend::interpreter, true), interpreter_result);
+		check(description + " (bytecode)", execute(code, backend::bytecode, false), "Error: test: " + bytecode_error);
+		check(description + " (optimised bytecode)", execute(code, backend::bytecode, true), "Error: test: " + bytecode_error);
+	}
+}
+
+void test_optimiser()
+{
+	//only numeric operands may lose an addition of zero
+	check_result("String plus zero", "x = \"a\"\n. x + 0\n", "a0");
+	check_result("Zero plus string", "x = \"a\"\n. 0 + x\n", "0a");
+
+	//an unsigned integer plus a signed zero is a signed integer which can no longer wrap around
+	check_result("Unsigned integer plus zero", "x = 0x5\n. x + 0 - 0x6\n", "-1");
+	check_result("Unsigned integer minus zero", "x = 0x5\n. x - 0 - 0x6\n", "-1");
+	check_result("Unsigned integer plus unsigned zero", "x = 0x5\n. x + 0x0 - 0x6\n", "18446744073709551615");
+
+	//adding zero turns a negative floating point zero into a positive one
+	check_result("Negative zero plus zero", ". -0.0 + 0\n", "0");
+	check_result("Negative zero variable plus zero", "x = -0.0\n. x + 0\n", "0");
+	check_result("Negative zero variable minus zero", "x = -0.0\n. x - 0\n", "-0");
+
+	//dividing the smallest signed integer by minus one traps so it must be left to the run time, it can't be executed here
+	check("Smallest integer divided by minus one", first_statement_is(". [-0x7fffffffffffffff - 1] / -1\n", fridh::parse_tree_node_type::binary_operator_node));
+	check("Smallest integer modulo minus one", first_statement_is(". [-0x7fffffffffffffff - 1] % -1\n", fridh::parse_tree_node_type::binary_operator_node));
+	check("Smallest integer divided by one", first_statement_is(". [-0x7fffffffffffffff - 1] / 1\n", fridh::parse_tree_node_type::variable));
+	check_result("Smallest integer divided by one", ". [-0x7fffffffffffffff - 1] / 1\n", "-9223372036854775808");
+
+	//the interpreter and the compiler leave the units of a module alone, only the optimiser removes them
+	std::string dead_code = "/ false\n\tx = 1\n\\\\ 0\n\tx = 2\n. 3\n";
+	check("Running a module keeps its dead code", get_unit_count(dead_code, false) == 3);
+	check("Optimising a module removes its dead code", get_unit_count(dead_code, true) == 1);
+	check_result("Dead branch and loop", dead_code, "3");
+
+	check_rejection("Unknown symbol in a dead branch", "/ false\n\tq\n. 1\n", "1", "Unknown symbol \"q\"");
+	check_rejection("Unknown symbol in a dead else branch", "/ true\n\tx = 1\n/\n\tx = q\n. x\n", "1", "Unknown symbol \"q\"");
+	check_rejection("Unknown symbol in a dead loop", "\\\\ false\n\tq[1]\n. 1\n", "1", "Unknown symbol \"q\"");
+	check_rejection("Unknown symbol after a return", ". 1\nx = q\n", "1", "Unknown symbol \"q\"");
+	check_rejection("Invalid argument count in a dead branch", "@f a\n\t. a\n\n/ false\n\tf[1 2]\n. 1\n", "1", "Invalid argument count in call to \"f\": expected 1, got 2");
+	check_rejection("Iterator in a dead branch", "/ false\n\tx = #\n. 1\n", "1", "Encountered an iterator outside of a for each statement");
+	check_result("Iterator in a dead branch of a for each loop", "x = 0\n\\ {1 2}\n\t/ false\n\t\tx = #\n\tx++\n. x\n", "2");
+}
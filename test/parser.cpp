@@ -0,0 +1,9 @@
+#include <test/test.hpp>
+
+void test_parser()
+{
+	//post-fix operators bind more tightly than prefix operators
+	check_result("Negated post-fix increment", "x = 3\ny = -x++\n. y * 10 + x\n", "-26");
+	check_result("Negated post-fix decrement", "x = 3\ny = -x--\n. y * 10 + x\n", "-28");
+	check_result("Nested prefix operators", "x = 0\n. !!x\n", "false");
+}
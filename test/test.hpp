@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <ail/types.hpp>
+
+namespace backend
+{
+	enum type
+	{
+		interpreter,
+		bytecode,
+	};
+}
+
+//the result of a module as returned by variable::get_string_representation or the error prefixed with "Error: "
+std::string execute(std::string const & code, backend::type method, bool optimise);
+
+//checks the result of both the interpreter and the virtual machine, with and without running the optimiser first
+void check_result(std::string const & description, std::string const & code, std::string const & expected);
+void check(std::string const & description, std::string const & result, std::string const & expected);
+void check(std::string const & description, bool success);
+
+void test_threads();
+void test_lexer();
+void test_parser();
+void test_optimiser();
+void test_incremental();
+void test_cache();
+void test_boxed();
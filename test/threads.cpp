@@ -0,0 +1,128 @@
+#include <vector>
+
+#include <fridh/parser.hpp>
+#include <fridh/flat.hpp>
+
+#include <boost/bind/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <ail/string.hpp>
+
+#include <test/test.hpp>
+
+namespace
+{
+	std::string generate_module(uword functions)
+	{
+		std::string output;
+		for(uword i = 0; i < functions; i++)
+		{
+			output +=
+				"@function_" + ail::number_to_string(i) + " a b\n"
+				"\tx = a + b * 3 - -a / 2\n"
+				"\ty = {a b x \"text\" 1.5}\n"
+				"\t/ x > b && a != 0\n"
+				"\t\tx = 2 * f[a b + 1]\n"
+				"\t/\n"
+				"\t\tx++\n"
+				"\t\\ y\n"
+				"\t\tx += # << 1\n"
+				"\t. x\n"
+				"\n";
+		}
+		output += ". 0\n";
+		return output;
+	}
+
+	//the statements of all the functions in the format of parse_tree_node::to_string plus the shape of the arena
+	std::string get_signature(std::string const & code)
+	{
+		fridh::module module;
+		fridh::parser parser;
+		std::string error;
+		if(!parser.process_data(code, "thread test", module, error))
+			return "Error: " + error;
+
+		fridh::flat_module flat;
+		fridh::flatten_module(module, flat);
+
+		std::string output = ail::number_to_string(module.arena.get_allocation_count()) + " node(s), " + ail::number_to_string(module.arena.get_size()) + " byte(s)\n";
+		for(std::size_t i = 0; i < flat.units.size(); i++)
+		{
+			fridh::flat_unit const & unit = flat.units[i];
+			if(unit.type == fridh::executable_unit_type::statement || unit.type == fridh::executable_unit_type::return_statement)
+				output += flat.to_string(unit.index) + "\n";
+		}
+		return output;
+	}
+
+	void parse_repeatedly(std::string const & code, std::vector<std::string> & signatures)
+	{
+		for(std::size_t i = 0; i < signatures.size(); i++)
+			signatures[i] = get_signature(code);
+	}
+
+	//copies of a variable on different threads share its payload until they get modified
+	void copy_repeatedly(fridh::variable const & shared, std::size_t iterations, bool & success)
+	{
+		success = true;
+		std::size_t size = shared.get_array().size();
+		for(std::size_t i = 0; i < iterations; i++)
+		{
+			fridh::variable copy(shared);
+			fridh::variable second_copy(copy);
+			fridh::variable element;
+			element.new_signed_integer(static_cast<fridh::types::signed_integer>(i));
+			copy.get_array().push_back(element);
+			if(copy.get_array().size() != size + 1 || second_copy.get_array().size() != size)
+				success = false;
+		}
+	}
+}
+
+//must run before anything else has been lexed or parsed so the threads also race on building the lookup tables
+void test_threads()
+{
+	std::size_t const thread_count = 4;
+	std::size_t const iterations = 5;
+
+	std::string code = generate_module(100);
+
+	std::vector<std::vector<std::string> > signatures(thread_count, std::vector<std::string>(iterations));
+	boost::thread_group threads;
+	for(std::size_t i = 0; i < thread_count; i++)
+		threads.create_thread(boost::bind(&parse_repeatedly, boost::cref(code), boost::ref(signatures[i])));
+	threads.join_all();
+
+	std::string reference = get_signature(code);
+	check("Single-threaded reference parse", reference.compare(0, 6, "Error:") != 0);
+	for(std::size_t i = 0; i < thread_count; i++)
+	{
+		for(std::size_t j = 0; j < iterations; j++)
+			check("Parse " + ail::number_to_string(j) + " on thread " + ail::number_to_string(i), signatures[i][j] == reference);
+	}
+
+	fridh::variable shared;
+	shared.new_array();
+	for(std::size_t i = 0; i < 10; i++)
+	{
+		fridh::variable element;
+		element.new_string("element " + ail::number_to_string(i));
+		shared.get_array().push_back(element);
+	}
+
+	bool copy_results[thread_count];
+	boost::thread_group copy_threads;
+	for(std::size_t i = 0; i < thread_count; i++)
+		copy_threads.create_thread(boost::bind(&copy_repeatedly, boost::cref(shared), 10000, boost::ref(copy_results[i])));
+	copy_threads.join_all();
+
+	for(std::size_t i = 0; i < thread_count; i++)
+		check("Copies of a shared array on thread " + ail::number_to_string(i), copy_results[i]);
+
+	fridh::types::vector const & elements = shared.get_array();
+	bool shared_array_intact = elements.size() == 10;
+	for(std::size_t i = 0; shared_array_intact && i < elements.size(); i++)
+		shared_array_intact = elements[i].get_string() == "element " + ail::number_to_string(i);
+	check("Shared array after the copies", shared_array_intact);
+}
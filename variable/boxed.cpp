@@ -0,0 +1,774 @@
+#include <algorithm>
+#include <cstring>
+#include <boost/static_assert.hpp>
+#include <fridh/boxed_variable.hpp>
+
+namespace fridh
+{
+	namespace
+	{
+		unsigned const tag_shift = 48;
+		boost::uint64_t const payload_mask = (static_cast<boost::uint64_t>(1) << tag_shift) - 1;
+
+		//every tag is a negative quiet NaN, canonical NaNs are positive so the lowest tag can't collide with an actual double
+		boost::uint64_t const minimum_tag = 0xfff8;
+		boost::uint64_t const heap_integer_tag = 0xfff8;
+		boost::uint64_t const special_tag = 0xfff9;
+		boost::uint64_t const signed_integer_tag = 0xfffa;
+		boost::uint64_t const unsigned_integer_tag = 0xfffb;
+		boost::uint64_t const string_tag = 0xfffc;
+		boost::uint64_t const array_tag = 0xfffd;
+		boost::uint64_t const map_tag = 0xfffe;
+		boost::uint64_t const function_tag = 0xffff;
+
+		boost::uint64_t const canonical_nan = static_cast<boost::uint64_t>(0x7ff8) << tag_shift;
+
+		//payloads of the special tag
+		boost::uint64_t const undefined_payload = 0;
+		boost::uint64_t const nil_payload = 1;
+		boost::uint64_t const none_payload = 2;
+		boost::uint64_t const false_payload = 3;
+		boost::uint64_t const true_payload = 4;
+
+		types::signed_integer const minimum_small_signed_integer = - (static_cast<types::signed_integer>(1) << (tag_shift - 1));
+		types::signed_integer const maximum_small_signed_integer = (static_cast<types::signed_integer>(1) << (tag_shift - 1)) - 1;
+	}
+
+	BOOST_STATIC_ASSERT(sizeof(boxed_variable) == 8);
+
+	boxed_variable::boxed_variable()
+	{
+		set(special_tag, undefined_payload);
+	}
+
+	boxed_variable::boxed_variable(boxed_variable const & other)
+	{
+		copy(other);
+	}
+
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+	boxed_variable::boxed_variable(boxed_variable && other) BOOST_NOEXCEPT
+	{
+		move(other);
+	}
+#endif
+
+	boxed_variable::boxed_variable(variable const & other)
+	{
+		set(special_tag, undefined_payload);
+		from_variable(other);
+	}
+
+	boxed_variable::~boxed_variable()
+	{
+		destroy();
+	}
+
+	boxed_variable & boxed_variable::operator=(boxed_variable const & other)
+	{
+		if(this == &other)
+			return *this;
+		destroy();
+		copy(other);
+		return *this;
+	}
+
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+	boxed_variable & boxed_variable::operator=(boxed_variable && other) BOOST_NOEXCEPT
+	{
+		if(this != &other)
+		{
+			destroy();
+			move(other);
+		}
+		return *this;
+	}
+#endif
+
+	void boxed_variable::copy(boxed_variable const & other)
+	{
+		bits = other.bits;
+
+		switch(other.get_tag())
+		{
+			case heap_integer_tag:
+				set_pointer(heap_integer_tag, new heap_integer(*reinterpret_cast<heap_integer *>(other.get_pointer())));
+				break;
+
+			case string_tag:
+				get_string_payload()->reference_count.fetch_add(1, boost::memory_order_relaxed);
+				break;
+
+			case array_tag:
+				get_array_payload()->reference_count.fetch_add(1, boost::memory_order_relaxed);
+				break;
+
+			case map_tag:
+				get_map_payload()->reference_count.fetch_add(1, boost::memory_order_relaxed);
+				break;
+		}
+	}
+
+	void boxed_variable::move(boxed_variable & other) BOOST_NOEXCEPT
+	{
+		bits = other.bits;
+		other.set(special_tag, undefined_payload);
+	}
+
+	void boxed_variable::destroy()
+	{
+		switch(get_tag())
+		{
+			case heap_integer_tag:
+				delete reinterpret_cast<heap_integer *>(get_pointer());
+				break;
+
+			case string_tag:
+				release_payload(get_string_payload());
+				break;
+
+			case array_tag:
+				release_payload(get_array_payload());
+				break;
+
+			case map_tag:
+				release_payload(get_map_payload());
+				break;
+		}
+
+		set(special_tag, undefined_payload);
+	}
+
+	void boxed_variable::swap(boxed_variable & other) BOOST_NOEXCEPT
+	{
+		std::swap(bits, other.bits);
+	}
+
+	boost::uint64_t boxed_variable::get_tag() const
+	{
+		//doubles have no tag
+		boost::uint64_t tag = bits >> tag_shift;
+		return tag >= minimum_tag ? tag : 0;
+	}
+
+	boost::uint64_t boxed_variable::get_payload() const
+	{
+		return bits & payload_mask;
+	}
+
+	void * boxed_variable::get_pointer() const
+	{
+		return reinterpret_cast<void *>(static_cast<std::size_t>(get_payload()));
+	}
+
+	shared_payload<types::string> * boxed_variable::get_string_payload() const
+	{
+		return reinterpret_cast<shared_payload<types::string> *>(get_pointer());
+	}
+
+	shared_payload<types::boxed_vector> * boxed_variable::get_array_payload() const
+	{
+		return reinterpret_cast<shared_payload<types::boxed_vector> *>(get_pointer());
+	}
+
+	shared_payload<types::boxed_map> * boxed_variable::get_map_payload() const
+	{
+		return reinterpret_cast<shared_payload<types::boxed_map> *>(get_pointer());
+	}
+
+	void boxed_variable::set(boost::uint64_t tag, boost::uint64_t payload)
+	{
+		bits = (tag << tag_shift) | (payload & payload_mask);
+	}
+
+	void boxed_variable::set_pointer(boost::uint64_t tag, void * pointer)
+	{
+		boost::uint64_t address = static_cast<boost::uint64_t>(reinterpret_cast<std::size_t>(pointer));
+		if(address > payload_mask)
+			throw ail::exception("Encountered a pointer which does not fit into a boxed variable");
+		set(tag, address);
+	}
+
+	void boxed_variable::set_integer(variable_type type, types::unsigned_integer value)
+	{
+		if(type == variable_type_identifier::signed_integer)
+		{
+			types::signed_integer signed_value = static_cast<types::signed_integer>(value);
+			if(signed_value >= minimum_small_signed_integer && signed_value <= maximum_small_signed_integer)
+			{
+				set(signed_integer_tag, static_cast<boost::uint64_t>(value));
+				return;
+			}
+		}
+		else if(value <= payload_mask)
+		{
+			set(unsigned_integer_tag, value);
+			return;
+		}
+
+		heap_integer * integer = new heap_integer;
+		integer->type = type;
+		integer->value = value;
+		set_pointer(heap_integer_tag, integer);
+	}
+
+	variable_type boxed_variable::get_type() const
+	{
+		switch(get_tag())
+		{
+			case 0:
+				return variable_type_identifier::floating_point_value;
+
+			case heap_integer_tag:
+				return reinterpret_cast<heap_integer *>(get_pointer())->type;
+
+			case special_tag:
+				switch(get_payload())
+				{
+					case nil_payload:
+						return variable_type_identifier::nil;
+
+					case none_payload:
+						return variable_type_identifier::none;
+
+					case false_payload:
+					case true_payload:
+						return variable_type_identifier::boolean;
+				}
+				return variable_type_identifier::undefined;
+
+			case signed_integer_tag:
+				return variable_type_identifier::signed_integer;
+
+			case unsigned_integer_tag:
+				return variable_type_identifier::unsigned_integer;
+
+			case string_tag:
+				return variable_type_identifier::string;
+
+			case array_tag:
+				return variable_type_identifier::array;
+
+			case map_tag:
+				return variable_type_identifier::map;
+
+			case function_tag:
+				return variable_type_identifier::function;
+		}
+
+		return variable_type_identifier::undefined;
+	}
+
+	bool boxed_variable::is_floating_point_value() const
+	{
+		return (bits >> tag_shift) < minimum_tag;
+	}
+
+	bool boxed_variable::is_small_signed_integer() const
+	{
+		return (bits >> tag_shift) == signed_integer_tag;
+	}
+
+	types::signed_integer boxed_variable::get_small_signed_integer() const
+	{
+		//sign extension of the 48-bit payload
+		return static_cast<types::signed_integer>(bits << (64 - tag_shift)) >> (64 - tag_shift);
+	}
+
+	types::floating_point_value boxed_variable::get_double() const
+	{
+		types::floating_point_value output;
+		std::memcpy(&output, &bits, sizeof(output));
+		return output;
+	}
+
+	void boxed_variable::nil()
+	{
+		destroy();
+		set(special_tag, nil_payload);
+	}
+
+	void boxed_variable::none()
+	{
+		destroy();
+		set(special_tag, none_payload);
+	}
+
+	void boxed_variable::new_boolean(types::boolean new_boolean)
+	{
+		destroy();
+		set(special_tag, new_boolean ? true_payload : false_payload);
+	}
+
+	void boxed_variable::new_signed_integer(types::signed_integer new_signed_integer)
+	{
+		destroy();
+		set_integer(variable_type_identifier::signed_integer, static_cast<types::unsigned_integer>(new_signed_integer));
+	}
+
+	void boxed_variable::new_unsigned_integer(types::unsigned_integer new_unsigned_integer)
+	{
+		destroy();
+		set_integer(variable_type_identifier::unsigned_integer, new_unsigned_integer);
+	}
+
+	void boxed_variable::new_floating_point_value(types::floating_point_value new_floating_point_value)
+	{
+		destroy();
+		if(new_floating_point_value != new_floating_point_value)
+			bits = canonical_nan;
+		else
+			std::memcpy(&bits, &new_floating_point_value, sizeof(bits));
+	}
+
+	void boxed_variable::new_string(types::string const & new_string)
+	{
+		shared_payload<types::string> * string = new shared_payload<types::string>(new_string);
+		destroy();
+		set_pointer(string_tag, string);
+	}
+
+	void boxed_variable::new_array()
+	{
+		destroy();
+		set_pointer(array_tag, new shared_payload<types::boxed_vector>);
+	}
+
+	void boxed_variable::new_map()
+	{
+		destroy();
+		set_pointer(map_tag, new shared_payload<types::boxed_map>);
+	}
+
+	void boxed_variable::new_function(function * new_function_pointer)
+	{
+		destroy();
+		set_pointer(function_tag, new_function_pointer);
+	}
+
+	types::boolean boxed_variable::get_boolean() const
+	{
+		if(get_tag() == special_tag)
+		{
+			switch(get_payload())
+			{
+				case false_payload:
+					return false;
+
+				case true_payload:
+					return true;
+			}
+		}
+
+		unary_argument_type_error("Boolean access", get_type());
+		return false;
+	}
+
+	types::signed_integer boxed_variable::get_signed_integer() const
+	{
+		return static_cast<types::signed_integer>(get_unsigned_integer());
+	}
+
+	types::unsigned_integer boxed_variable::get_unsigned_integer() const
+	{
+		switch(get_tag())
+		{
+			case signed_integer_tag:
+				return static_cast<types::unsigned_integer>(get_small_signed_integer());
+
+			case unsigned_integer_tag:
+				return get_payload();
+
+			case heap_integer_tag:
+				return reinterpret_cast<heap_integer *>(get_pointer())->value;
+		}
+
+		unary_argument_type_error("Integer access", get_type());
+		return 0;
+	}
+
+	types::floating_point_value boxed_variable::get_floating_point_value() const
+	{
+		switch(get_type())
+		{
+			case variable_type_identifier::signed_integer:
+				return static_cast<types::floating_point_value>(get_signed_integer());
+
+			case variable_type_identifier::unsigned_integer:
+				return static_cast<types::floating_point_value>(get_unsigned_integer());
+
+			case variable_type_identifier::floating_point_value:
+				return get_double();
+
+			default:
+				break;
+		}
+
+		throw ail::exception("Failed to retrieve floating point value");
+	}
+
+	types::string const & boxed_variable::get_string() const
+	{
+		if(get_tag() != string_tag)
+			unary_argument_type_error("String access", get_type());
+		return get_string_payload()->data;
+	}
+
+	types::boxed_vector & boxed_variable::get_array()
+	{
+		if(get_tag() != array_tag)
+			unary_argument_type_error("Array access", get_type());
+		//the caller may modify the array so it must not be shared with other variables
+		shared_payload<types::boxed_vector> * payload = get_array_payload();
+		detach_payload(payload);
+		set_pointer(array_tag, payload);
+		return payload->data;
+	}
+
+	types::boxed_vector const & boxed_variable::get_array() const
+	{
+		if(get_tag() != array_tag)
+			unary_argument_type_error("Array access", get_type());
+		return get_array_payload()->data;
+	}
+
+	function * boxed_variable::get_function() const
+	{
+		if(get_tag() != function_tag)
+			unary_argument_type_error("Function access", get_type());
+		return reinterpret_cast<function *>(get_pointer());
+	}
+
+	bool boxed_variable::get_boolean_value() const
+	{
+		switch(get_tag())
+		{
+			case special_tag:
+				switch(get_payload())
+				{
+					case false_payload:
+						return false;
+
+					case true_payload:
+						return true;
+				}
+				break;
+
+			case signed_integer_tag:
+			case unsigned_integer_tag:
+				return get_payload() != 0;
+
+			case heap_integer_tag:
+				return reinterpret_cast<heap_integer *>(get_pointer())->value != 0;
+		}
+
+		unary_argument_type_error("Boolean representation", get_type());
+
+		//should never get here, suppress warnings
+		return false;
+	}
+
+	std::string boxed_variable::get_string_representation() const
+	{
+		if(get_tag() == string_tag)
+			return get_string_payload()->data;
+
+		variable value;
+		to_variable(value);
+		return value.get_string_representation();
+	}
+
+	void boxed_variable::to_variable(variable & output) const
+	{
+		variable_type type = get_type();
+		switch(type)
+		{
+			case variable_type_identifier::nil:
+				output.nil();
+				break;
+
+			case variable_type_identifier::none:
+				output.none();
+				break;
+
+			case variable_type_identifier::boolean:
+				output.new_boolean(get_boolean_value());
+				break;
+
+			case variable_type_identifier::signed_integer:
+				output.new_signed_integer(static_cast<types::signed_integer>(get_unsigned_integer()));
+				break;
+
+			case variable_type_identifier::unsigned_integer:
+				output.new_unsigned_integer(get_unsigned_integer());
+				break;
+
+			case variable_type_identifier::floating_point_value:
+				output.new_floating_point_value(get_double());
+				break;
+
+			case variable_type_identifier::string:
+			{
+				//both representations use the same string payload
+				shared_payload<types::string> * string = get_string_payload();
+				string->reference_count.fetch_add(1, boost::memory_order_relaxed);
+				output.destroy();
+				output.type = variable_type_identifier::string;
+				output.string = string;
+				break;
+			}
+
+			case variable_type_identifier::array:
+			{
+				types::boxed_vector const & elements = get_array_payload()->data;
+				variable array;
+				array.new_array();
+				types::vector & output_elements = array.get_array();
+				output_elements.resize(elements.size());
+				for(std::size_t i = 0, end = elements.size(); i < end; i++)
+					elements[i].to_variable(output_elements[i]);
+				output = array;
+				break;
+			}
+
+			case variable_type_identifier::map:
+			{
+				types::boxed_map const & elements = get_map_payload()->data;
+				variable map;
+				map.new_map();
+				for(types::boxed_map::const_iterator i = elements.begin(), end = elements.end(); i != end; i++)
+				{
+					variable key;
+					i->first.to_variable(key);
+					i->second.to_variable(map.map->data[key]);
+				}
+				output = map;
+				break;
+			}
+
+			case variable_type_identifier::function:
+				output.new_function(get_function());
+				break;
+
+			default:
+				output.destroy();
+				break;
+		}
+	}
+
+	void boxed_variable::from_variable(variable const & input)
+	{
+		switch(input.get_type())
+		{
+			case variable_type_identifier::nil:
+				nil();
+				break;
+
+			case variable_type_identifier::none:
+				none();
+				break;
+
+			case variable_type_identifier::boolean:
+				new_boolean(input.boolean);
+				break;
+
+			case variable_type_identifier::signed_integer:
+				new_signed_integer(input.signed_integer);
+				break;
+
+			case variable_type_identifier::unsigned_integer:
+				new_unsigned_integer(input.unsigned_integer);
+				break;
+
+			case variable_type_identifier::floating_point_value:
+				new_floating_point_value(input.floating_point_value);
+				break;
+
+			case variable_type_identifier::string:
+				input.string->reference_count.fetch_add(1, boost::memory_order_relaxed);
+				destroy();
+				set_pointer(string_tag, input.string);
+				break;
+
+			case variable_type_identifier::array:
+			{
+				types::vector const & elements = input.array->data;
+				shared_payload<types::boxed_vector> * output_elements = new shared_payload<types::boxed_vector>;
+				output_elements->data.resize(elements.size());
+				for(std::size_t i = 0, end = elements.size(); i < end; i++)
+					output_elements->data[i].from_variable(elements[i]);
+				destroy();
+				set_pointer(array_tag, output_elements);
+				break;
+			}
+
+			case variable_type_identifier::map:
+			{
+				types::map const & elements = input.map->data;
+				shared_payload<types::boxed_map> * output_elements = new shared_payload<types::boxed_map>;
+				for(types::map::const_iterator i = elements.begin(), end = elements.end(); i != end; i++)
+					output_elements->data[boxed_variable(i->first)].from_variable(i->second);
+				destroy();
+				set_pointer(map_tag, output_elements);
+				break;
+			}
+
+			case variable_type_identifier::function:
+				new_function(input.function_pointer);
+				break;
+
+			default:
+				destroy();
+				break;
+		}
+	}
+
+	//operations which are not covered by a fast path are performed by the regular variable implementation
+
+#define GENERIC_BINARY_OPERATION(name) \
+		variable left, right, result; \
+		to_variable(left); \
+		argument.to_variable(right); \
+		left.name(right, result); \
+		output.from_variable(result);
+
+#define GENERIC_UNARY_OPERATION(name) \
+		variable argument, result; \
+		to_variable(argument); \
+		argument.name(result); \
+		output.from_variable(result);
+
+	//integer arithmetic wraps around just like the 64-bit operations of variable do
+#define ARITHMETIC_OPERATOR(name, operator) \
+	void boxed_variable::name(boxed_variable const & argument, boxed_variable & output) const \
+	{ \
+		if(is_small_signed_integer() && argument.is_small_signed_integer()) \
+			output.new_signed_integer(static_cast<types::signed_integer>(static_cast<types::unsigned_integer>(get_small_signed_integer()) operator static_cast<types::unsigned_integer>(argument.get_small_signed_integer()))); \
+		else if(is_floating_point_value() && argument.is_floating_point_value()) \
+			output.new_floating_point_value(get_double() operator argument.get_double()); \
+		else \
+		{ \
+			GENERIC_BINARY_OPERATION(name) \
+		} \
+	}
+
+	ARITHMETIC_OPERATOR(addition, +)
+	ARITHMETIC_OPERATOR(subtraction, -)
+	ARITHMETIC_OPERATOR(multiplication, *)
+
+#undef ARITHMETIC_OPERATOR
+
+#define NUMERIC_COMPARISON(name, operator) \
+	void boxed_variable::name(boxed_variable const & argument, boxed_variable & output) const \
+	{ \
+		if(is_small_signed_integer() && argument.is_small_signed_integer()) \
+			output.new_boolean(get_small_signed_integer() operator argument.get_small_signed_integer()); \
+		else if(is_floating_point_value() && argument.is_floating_point_value()) \
+			output.new_boolean(get_double() operator argument.get_double()); \
+		else \
+		{ \
+			GENERIC_BINARY_OPERATION(name) \
+		} \
+	}
+
+	NUMERIC_COMPARISON(less_than, <)
+	NUMERIC_COMPARISON(less_than_or_equal, <=)
+	NUMERIC_COMPARISON(greater_than, >)
+	NUMERIC_COMPARISON(greater_than_or_equal, >=)
+
+#undef NUMERIC_COMPARISON
+
+#define GENERIC_BINARY_OPERATOR(name) \
+	void boxed_variable::name(boxed_variable const & argument, boxed_variable & output) const \
+	{ \
+		GENERIC_BINARY_OPERATION(name) \
+	}
+
+	GENERIC_BINARY_OPERATOR(division)
+	GENERIC_BINARY_OPERATOR(modulo)
+
+	GENERIC_BINARY_OPERATOR(shift_left)
+	GENERIC_BINARY_OPERATOR(shift_right)
+
+	GENERIC_BINARY_OPERATOR(binary_and)
+	GENERIC_BINARY_OPERATOR(binary_or)
+	GENERIC_BINARY_OPERATOR(binary_xor)
+
+#undef GENERIC_BINARY_OPERATOR
+
+	void boxed_variable::not_equal(boxed_variable const & argument, boxed_variable & output) const
+	{
+		output.new_boolean(operator!=(argument));
+	}
+
+	void boxed_variable::equal(boxed_variable const & argument, boxed_variable & output) const
+	{
+		output.new_boolean(operator==(argument));
+	}
+
+	void boxed_variable::logical_not(boxed_variable & output) const
+	{
+		output.new_boolean(!get_boolean_value());
+	}
+
+	void boxed_variable::logical_and(boxed_variable const & argument, boxed_variable & output) const
+	{
+		output.new_boolean(get_boolean_value() && argument.get_boolean_value());
+	}
+
+	void boxed_variable::logical_or(boxed_variable const & argument, boxed_variable & output) const
+	{
+		output.new_boolean(get_boolean_value() || argument.get_boolean_value());
+	}
+
+	void boxed_variable::binary_not(boxed_variable & output) const
+	{
+		GENERIC_UNARY_OPERATION(binary_not)
+	}
+
+	void boxed_variable::negation(boxed_variable & output) const
+	{
+		if(is_small_signed_integer())
+			output.new_signed_integer(- get_small_signed_integer());
+		else if(is_floating_point_value())
+			output.new_floating_point_value(- get_double());
+		else
+		{
+			GENERIC_UNARY_OPERATION(negation)
+		}
+	}
+
+#undef GENERIC_UNARY_OPERATION
+#undef GENERIC_BINARY_OPERATION
+
+	bool boxed_variable::operator==(boxed_variable const & other) const
+	{
+		if(is_small_signed_integer() && other.is_small_signed_integer())
+			return bits == other.bits;
+		else if(is_floating_point_value() && other.is_floating_point_value())
+			return get_double() == other.get_double();
+
+		variable left, right;
+		to_variable(left);
+		other.to_variable(right);
+		return left == right;
+	}
+
+	bool boxed_variable::operator!=(boxed_variable const & other) const
+	{
+		return !operator==(other);
+	}
+
+	bool boxed_variable::operator<(boxed_variable const & other) const
+	{
+		if(is_small_signed_integer() && other.is_small_signed_integer())
+			return get_small_signed_integer() < other.get_small_signed_integer();
+		else if(is_floating_point_value() && other.is_floating_point_value())
+			return get_double() < other.get_double();
+
+		variable left, right;
+		to_variable(left);
+		other.to_variable(right);
+		return left < right;
+	}
+}
@@ -4,53 +4,69 @@ namespace fridh
 {
 	void variable::nil()
 	{
+		destroy();
 		type = variable_type_identifier::nil;
 	}
 
 	void variable::none()
 	{
+		destroy();
 		type = variable_type_identifier::none;
 	}
 
 	void variable::new_boolean(types::boolean new_boolean)
 	{
+		destroy();
 		type = variable_type_identifier::boolean;
 		boolean = new_boolean;
 	}
 
 	void variable::new_signed_integer(types::signed_integer new_signed_integer)
 	{
+		destroy();
 		type = variable_type_identifier::signed_integer;
 		signed_integer = new_signed_integer;
 	}
 
 	void variable::new_unsigned_integer(types::unsigned_integer new_unsigned_integer)
 	{
+		destroy();
 		type = variable_type_identifier::unsigned_integer;
 		unsigned_integer = new_unsigned_integer;
 	}
 
 	void variable::new_floating_point_value(types::floating_point_value new_floating_point_value)
 	{
+		destroy();
 		type = variable_type_identifier::floating_point_value;
 		floating_point_value = new_floating_point_value;
 	}
 
 	void variable::new_string(types::string const & new_string)
 	{
+		destroy();
 		type = variable_type_identifier::string;
-		string = new std::string(new_string);
+		string = new shared_payload<types::string>(new_string);
 	}
 
 	void variable::new_array()
 	{
+		destroy();
 		type = variable_type_identifier::array;
-		array = new types::vector();
+		array = new shared_payload<types::vector>;
 	}
 
 	void variable::new_map()
 	{
+		destroy();
 		type = variable_type_identifier::map;
-		map = new types::map();
+		map = new shared_payload<types::map>;
+	}
+
+	void variable::new_function(function * new_function_pointer)
+	{
+		destroy();
+		type = variable_type_identifier::function;
+		function_pointer = new_function_pointer;
 	}
 }
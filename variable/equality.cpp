@@ -6,8 +6,8 @@ namespace fridh
 	bool variable::array_equality(variable const & other) const
 	{
 		types::vector
-			& vector = *array,
-			& other_vector = *other.array;
+			& vector = array->data,
+			& other_vector = other.array->data;
 
 		std::size_t size = vector.size();
 		if(size != vector.size())
@@ -25,8 +25,8 @@ namespace fridh
 	bool variable::map_equality(variable const & other) const
 	{
 		types::map
-			& this_map = *map,
-			& other_map = *other.map;
+			& this_map = map->data,
+			& other_map = other.map->data;
 
 		if(this_map.size() != other_map.size())
 			return false;
@@ -66,7 +66,7 @@ namespace fridh
 				return type == other.type && boolean == other.boolean;
 
 			case variable_type_identifier::string:
-				return type == other.type && *string == *other.string;
+				return type == other.type && string->data == other.string->data;
 
 			case variable_type_identifier::array:
 				return array_equality(other);
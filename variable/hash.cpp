@@ -7,7 +7,7 @@ namespace fridh
 	uword variable::array_hash(uword previous_hash) const
 	{
 		uword hash = previous_hash;
-		for(types::vector::iterator i = array->begin(), end = array->end(); i != end; i++)
+		for(types::vector::const_iterator i = array->data.begin(), end = array->data.end(); i != end; i++)
 			hash = i->hash(hash);
 		return hash;
 	}
@@ -15,7 +15,7 @@ namespace fridh
 	uword variable::map_hash(uword previous_hash) const
 	{
 		uword hash = previous_hash;
-		for(types::map::iterator i = map->begin(), end = map->end(); i != end; i++)
+		for(types::map::const_iterator i = map->data.begin(), end = map->data.end(); i != end; i++)
 		{
 			hash = i->first.hash(hash);
 			hash = i->second.hash(hash);
@@ -54,7 +54,7 @@ namespace fridh
 			return fnv1a_hash(&hash_pointer, sizeof(types::floating_point_value), previous_hash);
 
 		case variable_type_identifier::string:
-			return fnv1a_hash(string->c_str(), string->size(), previous_hash);
+			return fnv1a_hash(string->data.c_str(), string->data.size(), previous_hash);
 
 		case variable_type_identifier::array:
 			return array_hash(previous_hash);
@@ -14,27 +14,31 @@ namespace fridh
 
 		if(left_is_array || right_is_array)
 		{
-			output.type = variable_type_identifier::array;
-			output.array = new types::vector;
-			types::vector & vector = *output.array;
+			//the output may be one of the arguments so it must not be modified before the new array has been constructed
+			shared_payload<types::vector> * new_array = new shared_payload<types::vector>;
+			types::vector & vector = new_array->data;
 
 			if(left_is_array && right_is_array)
 			{
-				vector = *array;
-				types::vector & right_vector = *argument.array;
+				vector = array->data;
+				types::vector & right_vector = argument.array->data;
 				vector.insert(vector.end(), right_vector.begin(), right_vector.end());
 			}
 			else if(left_is_array && !right_is_array)
 			{
-				vector = *array;
+				vector = array->data;
 				vector.push_back(argument);
 			}
 			else if(!left_is_array && right_is_array)
 			{
-				vector = *argument.array;
+				vector = argument.array->data;
 				vector.push_back(*this);
 			}
 
+			output.destroy();
+			output.type = variable_type_identifier::array;
+			output.array = new_array;
+
 			return true;
 		}
 		else
@@ -48,9 +52,7 @@ namespace fridh
 
 		if(left_is_string || right_is_string)
 		{
-			output.type = variable_type_identifier::string;
-			output.string = new std::string;
-			*output.string = get_string_representation() + argument.get_string_representation();
+			output.new_string(get_string_representation() + argument.get_string_representation());
 			return true;
 		}
 		else
@@ -115,20 +117,18 @@ namespace fridh
 
 	void variable::negation(variable & output) const
 	{
-		output.type = type;
 		switch(type)
 		{
 		case variable_type_identifier::signed_integer:
-			output.signed_integer = - signed_integer;
+			output.new_signed_integer(- signed_integer);
 			break;
 
 		case variable_type_identifier::unsigned_integer:
-			output.type = variable_type_identifier::signed_integer;
-			output.signed_integer = - static_cast<types::signed_integer>(unsigned_integer);
+			output.new_signed_integer(- static_cast<types::signed_integer>(unsigned_integer));
 			break;
 
 		case variable_type_identifier::floating_point_value:
-			output.floating_point_value = - floating_point_value;
+			output.new_floating_point_value(- floating_point_value);
 			break;
 
 		default:
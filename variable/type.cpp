@@ -26,5 +26,55 @@ namespace fridh
 			type == variable_type_identifier::unsigned_integer ||
 			type == variable_type_identifier::floating_point_value;
 	}
-}
 
+	types::boolean variable::get_boolean() const
+	{
+		if(type != variable_type_identifier::boolean)
+			unary_argument_type_error("Boolean access", type);
+		return boolean;
+	}
+
+	types::signed_integer variable::get_signed_integer() const
+	{
+		if(!is_integer_type())
+			unary_argument_type_error("Integer access", type);
+		return signed_integer;
+	}
+
+	types::unsigned_integer variable::get_unsigned_integer() const
+	{
+		if(!is_integer_type())
+			unary_argument_type_error("Integer access", type);
+		return unsigned_integer;
+	}
+
+	types::string const & variable::get_string() const
+	{
+		if(type != variable_type_identifier::string)
+			unary_argument_type_error("String access", type);
+		return string->data;
+	}
+
+	types::vector & variable::get_array()
+	{
+		if(type != variable_type_identifier::array)
+			unary_argument_type_error("Array access", type);
+		//the caller may modify the array so it must not be shared with other variables
+		make_unique();
+		return array->data;
+	}
+
+	types::vector const & variable::get_array() const
+	{
+		if(type != variable_type_identifier::array)
+			unary_argument_type_error("Array access", type);
+		return array->data;
+	}
+
+	function * variable::get_function() const
+	{
+		if(type != variable_type_identifier::function)
+			unary_argument_type_error("Function access", type);
+		return function_pointer;
+	}
+}
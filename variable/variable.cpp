@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <ail/string.hpp>
 #include <fridh/symbol.hpp>
 
@@ -20,11 +21,43 @@ namespace fridh
 
 	variable & variable::operator=(variable const & other)
 	{
+		if(this == &other)
+			return *this;
 		destroy();
 		copy(other);
 		return *this;
 	}
 
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+	variable::variable(variable && other) BOOST_NOEXCEPT
+	{
+		move(other);
+	}
+
+	variable & variable::operator=(variable && other) BOOST_NOEXCEPT
+	{
+		if(this != &other)
+		{
+			destroy();
+			move(other);
+		}
+		return *this;
+	}
+#endif
+
+	void variable::move(variable & other) BOOST_NOEXCEPT
+	{
+		type = other.type;
+		unsigned_integer = other.unsigned_integer;
+		other.type = variable_type_identifier::undefined;
+	}
+
+	void variable::swap(variable & other) BOOST_NOEXCEPT
+	{
+		std::swap(type, other.type);
+		std::swap(unsigned_integer, other.unsigned_integer);
+	}
+
 	void variable::copy(variable const & other)
 	{
 		type = other.type;
@@ -34,9 +67,10 @@ namespace fridh
 				type = other.type; \
 				break;
 
-#define COPY_MEMBER_POINTER(type, member_type, member) \
+#define SHARE_MEMBER(type) \
 			case variable_type_identifier::type: \
-				member = new member_type(*other.member); \
+				type = other.type; \
+				type->reference_count.fetch_add(1, boost::memory_order_relaxed); \
 				break;
 
 		switch(type)
@@ -46,12 +80,16 @@ namespace fridh
 			COPY_MEMBER(unsigned_integer)
 			COPY_MEMBER(floating_point_value)
 
-			COPY_MEMBER_POINTER(string, std::string, string)
-			COPY_MEMBER_POINTER(array, types::vector, array)
-			COPY_MEMBER_POINTER(map, types::map, map)
+			case variable_type_identifier::function:
+				function_pointer = other.function_pointer;
+				break;
+
+			SHARE_MEMBER(string)
+			SHARE_MEMBER(array)
+			SHARE_MEMBER(map)
 		}
 
-#undef COPY_MEMBER_POINTER
+#undef SHARE_MEMBER
 #undef COPY_MEMBER
 
 	}
@@ -59,24 +97,48 @@ namespace fridh
 	void variable::destroy()
 	{
 
-#define DELETE_MEMBER(type) \
+#define RELEASE_MEMBER(type) \
 			case variable_type_identifier::type: \
-				delete type; \
+				release_payload(type); \
 				break;
 
 		switch(type)
 		{
-			DELETE_MEMBER(string)
-			DELETE_MEMBER(array)
-			DELETE_MEMBER(map)
+			RELEASE_MEMBER(string)
+			RELEASE_MEMBER(array)
+			RELEASE_MEMBER(map)
+
+			default:
+				break;
 		}
 
 		type = variable_type_identifier::undefined;
 
-#undef DELETE_MEMBER
+#undef RELEASE_MEMBER
 
 	}
 
+	void variable::make_unique()
+	{
+		switch(type)
+		{
+			case variable_type_identifier::string:
+				detach_payload(string);
+				break;
+
+			case variable_type_identifier::array:
+				detach_payload(array);
+				break;
+
+			case variable_type_identifier::map:
+				detach_payload(map);
+				break;
+
+			default:
+				break;
+		}
+	}
+
 	types::floating_point_value variable::get_floating_point_value() const
 	{
 		switch(type)
@@ -111,7 +173,7 @@ namespace fridh
 			return ail::number_to_string<types::floating_point_value>(floating_point_value);
 
 		case variable_type_identifier::string:
-			return *string;
+			return string->data;
 		}
 
 		unary_argument_type_error("String representation", type);
@@ -181,7 +243,7 @@ namespace fridh
 		else
 		{
 			if(type == variable_type_identifier::string)
-				return *string < *other.string;
+				return string->data < other.string->data;
 			else
 				return hash() < other.hash();
 		}